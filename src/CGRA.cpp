@@ -10,7 +10,9 @@
 
 #include <fstream>
 #include "CGRA.h"
+#include "Logger.h"
 #include "json.hpp"
+#include <assert.h>
 
 using json = nlohmann::json;
 
@@ -24,6 +26,7 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
   m_supportDVFS = t_supportDVFS;
   m_DVFSIslandDim = t_DVFSIslandDim;
   m_supportInclusive = enableMultipleOps;
+  m_journalEnabled = false;
   m_supportComplex = new list<string>();
   m_supportCall = new list<string>();
   nodes = new CGRANode**[t_rows];
@@ -65,7 +68,7 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
 
     ifstream paramCGRA("./param.json");
     if (!paramCGRA.good()) {
-      cout<<"Parameterizable CGRA design/mapping requires paramCGRA.json"<<endl;
+      LOG(LOG_LEVEL_ERROR)<<"Parameterizable CGRA design/mapping requires paramCGRA.json"<<endl;
       return;
     }
     json param;
@@ -95,9 +98,9 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
         } else {
           id2Node[nodeID]->disableAllFUs();
           auto supportedFUs = param["tiles"][to_string(nodeID)]["supportedFUs"];
-          cout << "Node " << nodeID << " supports: ";
+          LOG(LOG_LEVEL_DEBUG) << "Node " << nodeID << " supports: ";
           for (const auto& fu : supportedFUs) {
-            cout << fu << " ";
+            LOG(LOG_LEVEL_DEBUG) << fu << " ";
             if (fu == "Add") {
               id2Node[nodeID]->enableAdd();
             } else if (fu == "Br") {
@@ -124,7 +127,7 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
               id2Node[nodeID]->enableStore();
             }
           }
-          cout << " \n " << endl;
+          LOG(LOG_LEVEL_DEBUG) << " \n \n";
         }
 	if (param["tiles"][to_string(nodeID)].contains("accessMem")) {
 	  if (param["tiles"][to_string(nodeID)]["accessMem"]) {
@@ -180,14 +183,14 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
         iter!=t_additionalFunc->end(); ++iter) {
       for (int nodeIndex: *(iter->second)) {
         if (nodeIndex >= m_FUCount) {
-          cout<<"\033[0;31mInvalid CGRA node ID "<<nodeIndex<<" for operation "<<iter->first<<"\033[0m"<<endl;
+          LOG(LOG_LEVEL_ERROR)<<"\033[0;31mInvalid CGRA node ID "<<nodeIndex<<" for operation "<<iter->first<<"\033[0m"<<endl;
           continue;
         } else {
           int row = nodeIndex / m_columns;
           int col = nodeIndex % m_columns;
           bool canEnable = nodes[row][col]->enableFunctionality(iter->first);
           if (!canEnable) {
-            cout<<"\033[0;31mInvalid operation "<<iter->first<<" on CGRA node ID "<<nodeIndex<<"\033[0m"<<endl;
+            LOG(LOG_LEVEL_ERROR)<<"\033[0;31mInvalid operation "<<iter->first<<" on CGRA node ID "<<nodeIndex<<"\033[0m"<<endl;
           } else {
             if ((iter->first).compare("store") == 0) {
               storeCount += 1;
@@ -200,13 +203,13 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
       }
     }
     if (storeCount == 0) {
-      cout<<"Without customization in param.json, we enable store functionality on the left most column."<<endl;
+      LOG(LOG_LEVEL_INFO)<<"Without customization in param.json, we enable store functionality on the left most column.\n";
       for (int r=0; r<t_rows; ++r) {
         nodes[r][0]->enableStore();
       }
     }
     if (loadCount == 0) {
-      cout<<"Without customization in param.json, we enable load functionality on the left most column."<<endl;
+      LOG(LOG_LEVEL_INFO)<<"Without customization in param.json, we enable load functionality on the left most column.\n";
       for (int r=0; r<t_rows; ++r) {
         nodes[r][0]->enableLoad();
       }
@@ -237,7 +240,7 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
       }
     } else {
       // "none" or else will be treated as none.
-      cout<<"No vectorization is enabled on the CGRA nodes."<<endl;
+      LOG(LOG_LEVEL_INFO)<<"No vectorization is enabled on the CGRA nodes.\n";
     }
 
     // Enable the heterogeneity.
@@ -294,6 +297,10 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
     disableSpecificConnections();
   }
 
+  for (int r=0; r<t_rows; ++r)
+    for (int c=0; c<t_columns; ++c)
+      nodes[r][c]->collectNeighbors();
+
   if (t_supportDVFS) {
     for (int r=0; r<t_rows; ++r) {
       for (int c=0; c<t_columns; ++c) {
@@ -316,7 +323,7 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
   }
 
 /*
-  cout<<"[connection] horizontal and vertical."<<endl;
+  LOG(LOG_LEVEL_INFO)<<"[connection] horizontal and vertical.\n";
   // Connect the CGRA nodes with diagonal links.
   for (int i=0; i<t_rows-1; ++i) {
     for (int j=0; j<t_columns-1; ++j) {
@@ -345,11 +352,89 @@ CGRA::CGRA(int t_rows, int t_columns, std::string t_vectorizationMode,
       m_links.push_back(link);
     }
   }
-  cout<<"[connection] diagonal."<<endl;
+  LOG(LOG_LEVEL_INFO)<<"[connection] diagonal.\n";
 */
 
 }
 
+// Clones the CGRA, including the current MRRG, so that different IIs can
+// be mapped concurrently onto independent copies. The tiles and links keep
+// their IDs and the order of the attached links.
+CGRA::CGRA(CGRA* t_cgra) {
+  m_rows = t_cgra->m_rows;
+  m_columns = t_cgra->m_columns;
+  m_FUCount = t_cgra->m_FUCount;
+  m_LinkCount = t_cgra->m_LinkCount;
+  m_supportDVFS = t_cgra->m_supportDVFS;
+  m_DVFSIslandDim = t_cgra->m_DVFSIslandDim;
+  m_supportInclusive = t_cgra->m_supportInclusive;
+  m_journalEnabled = false;
+  m_supportComplex = new list<string>(*(t_cgra->m_supportComplex));
+  m_supportCall = new list<string>(*(t_cgra->m_supportCall));
+
+  nodes = new CGRANode**[m_rows];
+  for (int i=0; i<m_rows; ++i) {
+    nodes[i] = new CGRANode*[m_columns];
+    for (int j=0; j<m_columns; ++j) {
+      nodes[i][j] = new CGRANode(t_cgra->nodes[i][j]);
+    }
+  }
+
+  links = new CGRALink*[m_LinkCount];
+  for (int i=0; i<m_LinkCount; ++i) {
+    CGRALink* link = t_cgra->links[i];
+    assert(link->getID() == i);
+    links[i] = new CGRALink(link);
+    links[i]->connect(getNode(link->getSrc()->getID()),
+                      getNode(link->getDst()->getID()));
+  }
+  for (int i=0; i<m_rows; ++i) {
+    for (int j=0; j<m_columns; ++j) {
+      for (CGRALink* link: *(t_cgra->nodes[i][j]->getInLinks()))
+        nodes[i][j]->attachInLink(links[link->getID()]);
+      for (CGRALink* link: *(t_cgra->nodes[i][j]->getOutLinks()))
+        nodes[i][j]->attachOutLink(links[link->getID()]);
+    }
+  }
+  for (int i=0; i<m_rows; ++i)
+    for (int j=0; j<m_columns; ++j)
+      nodes[i][j]->collectNeighbors();
+
+  for (auto& island: t_cgra->m_DVFSIslands) {
+    for (CGRANode* node: island.second) {
+      m_DVFSIslands[island.first].push_back(getNode(node->getID()));
+    }
+  }
+}
+
+CGRA::~CGRA() {
+  for (int i=0; i<m_rows; ++i) {
+    for (int j=0; j<m_columns; ++j)
+      delete nodes[i][j];
+    delete[] nodes[i];
+  }
+  delete[] nodes;
+  for (int i=0; i<m_LinkCount; ++i)
+    delete links[i];
+  delete[] links;
+  delete m_supportComplex;
+  delete m_supportCall;
+}
+
+// Takes over the mapping state from a clone of this CGRA.
+void CGRA::copyMRRG(CGRA* t_cgra) {
+  for (int i=0; i<m_rows; ++i)
+    for (int j=0; j<m_columns; ++j)
+      nodes[i][j]->copyMRRG(t_cgra->nodes[i][j]);
+  for (int i=0; i<m_LinkCount; ++i)
+    links[i]->copyMRRG(t_cgra->links[i]);
+}
+
+// The tiles are numbered in row-major order.
+CGRANode* CGRA::getNode(int t_id) {
+  return nodes[t_id / m_columns][t_id % m_columns];
+}
+
 list<string>* CGRA::getSupportComplex() {
     return m_supportComplex;
 }
@@ -411,6 +496,7 @@ int CGRA::getFUCount() {
 }
 
 void CGRA::constructMRRG(int t_II) {
+  m_journal.clear();
   for (int i=0; i<m_rows; ++i)
     for (int j=0; j<m_columns; ++j)
       nodes[i][j]->constructMRRG(m_FUCount, t_II);
@@ -418,6 +504,37 @@ void CGRA::constructMRRG(int t_II) {
     links[i]->constructMRRG(m_FUCount, t_II);
 }
 
+void CGRA::setJournal(MappingJournal* t_journal) {
+  m_journal.clear();
+  for (int i=0; i<m_rows; ++i)
+    for (int j=0; j<m_columns; ++j)
+      nodes[i][j]->setJournal(t_journal);
+  for (int i=0; i<m_LinkCount; ++i)
+    links[i]->setJournal(t_journal);
+}
+
+void CGRA::enableJournal() {
+  setJournal(&m_journal);
+  m_journalEnabled = true;
+}
+
+void CGRA::disableJournal() {
+  setJournal(NULL);
+  m_journalEnabled = false;
+}
+
+bool CGRA::isJournalEnabled() {
+  return m_journalEnabled;
+}
+
+int CGRA::getJournalMark() {
+  return m_journal.getMark();
+}
+
+void CGRA::rollback(int t_mark) {
+  m_journal.rollback(t_mark);
+}
+
 CGRALink* CGRA::getLink(CGRANode* t_n1, CGRANode* t_n2) {
    for (int i=0; i<m_LinkCount; ++i) {
      if (links[i]->getSrc()==t_n1 and links[i]->getDst() == t_n2) {
@@ -442,7 +559,7 @@ void CGRA::syncDVFSIsland(CGRANode* t_node) {
   for (auto& nodeWithinIsland : m_DVFSIslands[islandID]) {
     nodeWithinIsland->setDVFSLatencyMultiple(t_node->getDVFSLatencyMultiple());
     nodeWithinIsland->syncDVFS();
-    cout << "[cheng] synced for node: " << nodeWithinIsland->getID() << "; check synced: " << nodeWithinIsland->isSynced() << "; addr: " << nodeWithinIsland << endl;
+    LOG(LOG_LEVEL_DEBUG) << "[cheng] synced for node: " << nodeWithinIsland->getID() << "; check synced: " << nodeWithinIsland->isSynced() << "; addr: " << nodeWithinIsland << "\n";
   }
 }
 
@@ -26,20 +26,34 @@ class CGRA {
     bool m_supportInclusive;
     int m_DVFSIslandDim;
     map<int, vector<CGRANode*>> m_DVFSIslands;
+    MappingJournal m_journal;
+    bool m_journalEnabled;
+    void setJournal(MappingJournal*);
     list<string>* m_supportComplex;
     list<string>* m_supportCall;
     void disableSpecificConnections();
 
   public:
     CGRA(int, int, std::string, list<string>*, bool, map<string, list<int>*>*, bool, int, bool=true);
+    CGRA(CGRA*);
+    ~CGRA();
     CGRANode ***nodes;
     CGRALink **links;
     int getFUCount();
     int getLinkCount();
     void getRoutingResource();
     void constructMRRG(int);
+    void copyMRRG(CGRA*);
+    // Records the changes of the MRRG so that the mapping can be rolled
+    // back to a mark taken earlier within the same MRRG.
+    void enableJournal();
+    void disableJournal();
+    bool isJournalEnabled();
+    int getJournalMark();
+    void rollback(int);
     int getRows() { return m_rows; }
     int getColumns() { return m_columns; }
+    CGRANode* getNode(int);
     CGRALink* getLink(CGRANode*, CGRANode*);
     void setBypassConstraint(int);
     void setCtrlMemConstraint(int);
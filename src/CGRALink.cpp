@@ -9,18 +9,31 @@
  */
 
 #include "CGRALink.h"
+#include "Logger.h"
+#include "MapperStats.h"
 #include <assert.h>
 
 CGRALink::CGRALink(int t_linkId) {
   setID(t_linkId);
   m_currentCtrlMemItems = 0;
-  m_occupied = new bool[1];
-  m_dfgNodes = new DFGNode*[1];
-  m_bypassed = new bool[1];
-  m_generatedOut = new bool[1];
-  m_arrived = new bool[1];
+  m_II = 1;
+  m_cycleBoundary = 0;
   m_disabled = false;
   m_mapped = false;
+  m_journal = NULL;
+}
+
+// Copies the link along with its current MRRG, which is used to clone the
+// CGRA. The connection is re-established by the cloned CGRA.
+CGRALink::CGRALink(CGRALink* t_link) {
+  setID(t_link->m_id);
+  m_src = NULL;
+  m_dst = NULL;
+  m_ctrlMemSize = t_link->m_ctrlMemSize;
+  m_bypassConstraint = t_link->m_bypassConstraint;
+  m_disabled = t_link->m_disabled;
+  m_journal = NULL;
+  copyMRRG(t_link);
 }
 
 void CGRALink::setCtrlMemConstraint(int t_ctrlMemConstraint) {
@@ -31,6 +44,10 @@ void CGRALink::setBypassConstraint(int t_bypassConstraint) {
   m_bypassConstraint = t_bypassConstraint;
 }
 
+int CGRALink::getBypassConstraint() {
+  return m_bypassConstraint;
+}
+
 void CGRALink::connect(CGRANode* t_src, CGRANode* t_dst) {
   m_src = t_src;
   m_dst = t_dst;
@@ -60,24 +77,51 @@ bool CGRALink::isMapped() {
 void CGRALink::constructMRRG(int t_CGRANodeCount, int t_II) {
   m_II = t_II;
   m_cycleBoundary = t_CGRANodeCount*t_II*t_II;
-  delete[] m_occupied;
-  m_occupied = new bool[m_cycleBoundary];
-  delete[] m_dfgNodes;
-  m_dfgNodes = new DFGNode*[m_cycleBoundary];
-  delete[] m_bypassed;
-  m_bypassed = new bool[m_cycleBoundary];
-  delete[] m_generatedOut;
-  m_generatedOut = new bool[m_cycleBoundary];
-  delete[] m_arrived;
-  m_arrived = new bool[m_cycleBoundary];
+  int words = (t_II + 63) / 64;
+  m_occupied.assign(words, 0);
+  m_bypassed.assign(words, 0);
+  m_generatedOut.assign(words, 0);
+  m_arrived.assign(words, 0);
+  m_dfgNodes.assign(t_II, NULL);
   m_currentCtrlMemItems = 0;
-  for(int i=0; i<m_cycleBoundary; ++i) {
-    m_occupied[i] = false;
-    m_dfgNodes[i] = NULL;
-    m_bypassed[i] = false;
-    m_generatedOut[i] = false;
-    m_arrived[i] = false;
-  }
+  addStatsCount(STATS_MRRG_BYTES, 4 * words * sizeof(unsigned long long) +
+                                  t_II * sizeof(DFGNode*));
+}
+
+// Takes over the reservations of the same link on another CGRA.
+void CGRALink::copyMRRG(CGRALink* t_link) {
+  m_II = t_link->m_II;
+  m_cycleBoundary = t_link->m_cycleBoundary;
+  m_currentCtrlMemItems = t_link->m_currentCtrlMemItems;
+  m_mapped = t_link->m_mapped;
+  m_occupied = t_link->m_occupied;
+  m_bypassed = t_link->m_bypassed;
+  m_generatedOut = t_link->m_generatedOut;
+  m_arrived = t_link->m_arrived;
+  m_dfgNodes = t_link->m_dfgNodes;
+}
+
+// The mapped flag is not recorded, as it is not reset by constructMRRG()
+// either.
+void CGRALink::setJournal(MappingJournal* t_journal) {
+  m_journal = t_journal;
+}
+
+int CGRALink::getSlot(int t_cycle) {
+  return (t_cycle%m_II + m_II) % m_II;
+}
+
+bool CGRALink::testSlot(vector<unsigned long long>& t_plane, int t_slot) {
+  return (t_plane[t_slot/64] >> (t_slot%64)) & 1;
+}
+
+void CGRALink::setSlot(vector<unsigned long long>& t_plane, int t_slot) {
+  t_plane[t_slot/64] |= 1ULL << (t_slot%64);
+}
+
+void CGRALink::journalSlot(vector<unsigned long long>& t_plane, int t_slot) {
+  if (m_journal != NULL)
+    m_journal->recordWord(&t_plane[t_slot/64]);
 }
 
 bool CGRALink::satisfyBypassConstraint(int t_cycle, int t_II) {
@@ -117,9 +161,12 @@ bool CGRALink::canOccupy(int t_cycle, int t_II) {
   // cout<<"[link->canOccupy() 0] ("<<m_src->getID()<<")->("<<m_dst->getID()<<")..."<<endl;
   if (m_disabled)
     return false;
+  // No resource is available beyond the MRRG.
+  if (t_cycle >= m_cycleBoundary)
+    return false;
   if (m_currentCtrlMemItems + 1 > m_ctrlMemSize)
     return false;
-  if (m_occupied[t_cycle])
+  if (isOccupied(t_cycle))
     return false;
   if (!satisfyBypassConstraint(t_cycle, t_II))
     return false;
@@ -132,11 +179,14 @@ bool CGRALink::canOccupy(DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode,
   // cout<<"[link->canOccupy() 1] ("<<m_src->getID()<<")->("<<m_dst->getID()<<")..."<<endl;
   if (m_disabled)
     return false;
-  if (m_dfgNodes[t_cycle] != NULL and t_srcDFGNode == m_dfgNodes[t_cycle])
+  // No resource is available beyond the MRRG.
+  if (t_cycle >= m_cycleBoundary)
+    return false;
+  if (getMappedDFGNode(t_cycle) != NULL and t_srcDFGNode == getMappedDFGNode(t_cycle))
     return true;
   if (m_currentCtrlMemItems + 1 > m_ctrlMemSize)
     return false;
-  if (m_occupied[t_cycle])
+  if (isOccupied(t_cycle))
     return false;
   if (!satisfyBypassConstraint(t_cycle, t_II))
     return false;
@@ -147,14 +197,14 @@ bool CGRALink::canOccupy(DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode,
   if (getSrc() == t_srcCGRANode) {
     int t = (t_cycle+1) % t_II;
     if (m_dfgNodes[t] != NULL and
-        !m_generatedOut[t]) {
+        !testSlot(m_generatedOut, t)) {
       return false;
     }
   } else { // On the other hand, the link for bypass is blocked
            // by the resultOut for 2 cycles:
     int t = (t_cycle+t_II-1) % t_II;
     if (m_dfgNodes[t] != NULL and
-        m_generatedOut[t]) {
+        testSlot(m_generatedOut, t)) {
       return false;
     }
   }
@@ -179,6 +229,58 @@ bool CGRALink::canOccupy(DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode,
   return true;
 }
 
+// The DFG nodes whose data blocks the source DFG node from occupying the
+// link at the given cycle, following the checks of canOccupy(), i.e.,
+// the one holding the slot, the ones bypassing through the other links
+// into the destination tile, and the one sharing the port of the xbar.
+// Returns the number of the blocking DFG nodes, which are appended to
+// 't_dfgNodes' if given, or -1 if the link cannot be occupied even if
+// they all give up their slots.
+int CGRALink::getBlockingDFGNodes(DFGNode* t_srcDFGNode,
+    CGRANode* t_srcCGRANode, int t_cycle, int t_II,
+    vector<DFGNode*>* t_dfgNodes) {
+  if (m_disabled or t_cycle >= m_cycleBoundary)
+    return -1;
+  if (getMappedDFGNode(t_cycle) == t_srcDFGNode)
+    return 0;
+  if (m_currentCtrlMemItems + 1 > m_ctrlMemSize)
+    return -1;
+  int cycle_in_II = (t_cycle+t_II) % t_II;
+  if (getDst()->isDVFSEnabled() and getDst()->getDVFSLatencyMultiple() > 1 and
+      cycle_in_II % getDst()->getDVFSLatencyMultiple() != 0)
+    return -1;
+  int count = 0;
+  auto block = [&](DFGNode* t_dfgNode) {
+    ++count;
+    if (t_dfgNodes != NULL)
+      t_dfgNodes->push_back(t_dfgNode);
+  };
+  if (isOccupied(t_cycle))
+    block(getMappedDFGNode(t_cycle));
+  if (!satisfyBypassConstraint(t_cycle, t_II)) {
+    // The computation on the destination tile cannot give up its slot.
+    if (getDst()->isOccupied(t_cycle+1, t_II) and m_bypassConstraint <= 1)
+      return -1;
+    for (CGRALink* inLink: *getDst()->getInLinks()) {
+      if (inLink != this and inLink->isOccupied(t_cycle) and
+          inLink->isBypass(t_cycle)) {
+        if (inLink->getMappedDFGNode(t_cycle) == t_srcDFGNode)
+          return -1;
+        block(inLink->getMappedDFGNode(t_cycle));
+      }
+    }
+  }
+  int t = getSrc() == t_srcCGRANode ? (t_cycle+1) % t_II :
+                                       (t_cycle+t_II-1) % t_II;
+  if (m_dfgNodes[t] != NULL and
+      testSlot(m_generatedOut, t) != (getSrc() == t_srcCGRANode)) {
+    if (m_dfgNodes[t] == t_srcDFGNode)
+      return -1;
+    block(m_dfgNodes[t]);
+  }
+  return count;
+}
+
 /*
 bool CGRALink::canOccupy(int t_cycle, int t_II) {
   if (m_currentCtrlMemItems + 1 > m_ctrlMemSize)
@@ -196,15 +298,25 @@ bool CGRALink::canOccupy(DFGNode* t_srcDFGNode, int t_cycle, int t_II) {
 */
 
 bool CGRALink::isOccupied(int t_cycle) {
-  return m_occupied[t_cycle];
+  return testSlot(m_occupied, getSlot(t_cycle));
+}
+
+// Number of the modulo slots in which the link is occupied.
+int CGRALink::getOccupiedSlotCount() {
+  int count = 0;
+  for (unsigned long long word: m_occupied) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
 }
 
 bool CGRALink::isOccupied(int t_cycle, int t_II, bool t_isStaticElasticCGRA) {
   int interval = t_II;
   if (t_isStaticElasticCGRA)
     interval = 1;
-  for (int i=t_cycle; i<m_cycleBoundary; i=i+interval) {
-    if (m_occupied[i]) {
+  // Checking one round of II is enough as the reservation repeats.
+  for (int i=t_cycle; i<m_cycleBoundary and i<t_cycle+m_II; i=i+interval) {
+    if (isOccupied(i)) {
       return true;
     }
   }
@@ -212,7 +324,7 @@ bool CGRALink::isOccupied(int t_cycle, int t_II, bool t_isStaticElasticCGRA) {
 }
 
 bool CGRALink::isReused(int t_cycle) {
-  return m_occupied[t_cycle];
+  return isOccupied(t_cycle);
 }
 
 void CGRALink::occupy(DFGNode* t_srcDFGNode, int t_cycle, int duration,
@@ -223,52 +335,46 @@ void CGRALink::occupy(DFGNode* t_srcDFGNode, int t_cycle, int duration,
     interval = 1;
     t_cycle = 0;
   }
-  for(int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=interval) {
-    m_dfgNodes[cycle] = t_srcDFGNode;
-    m_occupied[cycle] = true;
-    // Only set 'm_bypassed' as true if it is bypassed.
-    // Will never set it back to false.
-    if (t_isBypass)
-      m_bypassed[cycle] = true;
-    if (t_isGeneratedOut)
-      m_generatedOut[cycle] = true;
-    // Only set 'm_arrived' as true if it is not bypassed.
-    // Will never set it back to false.
-    if (!t_isBypass)
-      m_arrived[cycle] = true;
-  }
-  for(int cycle=t_cycle; cycle>=0; cycle-=interval) {
-    m_dfgNodes[cycle] = t_srcDFGNode;
-    m_occupied[cycle] = true;
+  // The link is reserved every 'interval' cycles, which covers a single
+  // modulo slot, or all of them for the static elastic CGRA.
+  for (int slot=getSlot(t_cycle)%interval; slot<m_II; slot+=interval) {
+    if (m_journal != NULL) {
+      m_journal->recordDFGNode(&m_dfgNodes[slot]);
+      journalSlot(m_occupied, slot);
+      journalSlot(m_bypassed, slot);
+      journalSlot(m_generatedOut, slot);
+      journalSlot(m_arrived, slot);
+    }
+    m_dfgNodes[slot] = t_srcDFGNode;
+    setSlot(m_occupied, slot);
     // Only set 'm_bypassed' as true if it is bypassed.
     // Will never set it back to false.
     if (t_isBypass)
-      m_bypassed[cycle] = true;
+      setSlot(m_bypassed, slot);
     if (t_isGeneratedOut)
-      m_generatedOut[cycle] = true;
+      setSlot(m_generatedOut, slot);
     // Only set 'm_arrived' as true if it is not bypassed.
     // Will never set it back to false.
     if (!t_isBypass)
-      m_arrived[cycle] = true;
+      setSlot(m_arrived, slot);
   }
   if (!t_isBypass) {
     m_dst->allocateReg(this, t_cycle, duration, interval);
   }
 
+  if (m_journal != NULL)
+    m_journal->recordInt(&m_currentCtrlMemItems);
   ++m_currentCtrlMemItems;
 
-  cout<<"[DEBUG] occupy link["<<m_src->getID()<<"]-->["<<m_dst->getID()<<"] (bypass:"<<t_isBypass<<") dfgNode: "<<t_srcDFGNode->getID()<<" at cycle "<<t_cycle<<"\n";
+  LOG(LOG_LEVEL_TRACE)<<"[DEBUG] occupy link["<<m_src->getID()<<"]-->["<<m_dst->getID()<<"] (bypass:"<<t_isBypass<<") dfgNode: "<<t_srcDFGNode->getID()<<" at cycle "<<t_cycle<<"\n";
 }
 
 DFGNode* CGRALink::getMappedDFGNode(int t_cycle) {
-  if (t_cycle < 0) {
-    return m_dfgNodes[m_II+t_cycle];
-  }
-  return m_dfgNodes[t_cycle];
+  return m_dfgNodes[getSlot(t_cycle)];
 }
 
 bool CGRALink::isBypass(int t_cycle) {
-  return m_bypassed[t_cycle];
+  return testSlot(m_bypassed, getSlot(t_cycle));
 }
 
 CGRANode* CGRALink::getSrc() {
@@ -16,6 +16,8 @@
 
 #include "CGRANode.h"
 #include "DFGNode.h"
+#include "MappingJournal.h"
+#include <vector>
 
 //using namespace llvm;
 using namespace std;
@@ -36,15 +38,24 @@ class CGRALink
 
     int m_cycleBoundary;
     bool m_disabled;
-    bool* m_occupied;
-    bool* m_bypassed;
-    bool* m_generatedOut;
-    bool* m_arrived;
-    DFGNode** m_dfgNodes;
+    // The reservation repeats every II cycles, so it is indexed by the
+    // modulo slot (i.e., cycle % II) with one bit-plane per flag.
+    vector<unsigned long long> m_occupied;
+    vector<unsigned long long> m_bypassed;
+    vector<unsigned long long> m_generatedOut;
+    vector<unsigned long long> m_arrived;
+    vector<DFGNode*> m_dfgNodes;
+    // Records the changes of the MRRG if it is not NULL.
+    MappingJournal* m_journal;
     bool satisfyBypassConstraint(int, int);
+    void journalSlot(vector<unsigned long long>&, int);
+    int getSlot(int);
+    bool testSlot(vector<unsigned long long>&, int);
+    void setSlot(vector<unsigned long long>&, int);
 
   public:
     CGRALink(int);
+    CGRALink(CGRALink*);
     void setID(int);
     int getID();
     CGRANode*  getSrc();
@@ -53,10 +64,14 @@ class CGRALink
     CGRANode* getConnectedNode(CGRANode*);
 
     void constructMRRG(int, int);
+    void copyMRRG(CGRALink*);
+    void setJournal(MappingJournal*);
     bool canOccupy(int, int);
     bool isOccupied(int);
     bool isOccupied(int, int, bool);
+    int getOccupiedSlotCount();
     bool canOccupy(DFGNode*, CGRANode*, int, int);
+    int getBlockingDFGNodes(DFGNode*, CGRANode*, int, int, vector<DFGNode*>*);
     void occupy(DFGNode*, int, int, int, bool, bool, bool);
     bool isBypass(int);
     string getDirection(CGRANode*);
@@ -9,6 +9,8 @@
  */
 
 #include "CGRANode.h"
+#include "Logger.h"
+#include "MapperStats.h"
 #include <stdio.h>
 
 #define SINGLE_OCCUPY     0 // A single-cycle opt is in the FU
@@ -36,11 +38,9 @@ CGRANode::CGRANode(int t_id, int t_x, int t_y) {
 
   m_x = t_x;
   m_y = t_y;
-  m_neighbors = NULL;
-  m_occupiableInLinks = NULL;
-  m_occupiableOutLinks = NULL;
   m_regs_duration = NULL;
   m_regs_timing = NULL;
+  m_II = 1;
 
   // used for parameterizable CGRA functional units
   m_canAdd    = true;
@@ -69,6 +69,98 @@ CGRANode::CGRANode(int t_id, int t_x, int t_y) {
   // simultaneously. (e.g.,  single-cycle overlaps with multi-cycle)
   // i.e., inclusive execution
   m_canMultipleOps = true;
+  m_journal = NULL;
+}
+
+// Copies the tile along with its current MRRG, which is used to clone the
+// CGRA. The links are attached again by the cloned CGRA.
+CGRANode::CGRANode(CGRANode* t_node) {
+  m_id = t_node->m_id;
+  m_x = t_node->m_x;
+  m_y = t_node->m_y;
+  m_registerCount = t_node->m_registerCount;
+  m_ctrlMemSize = t_node->m_ctrlMemSize;
+  m_regs_duration = NULL;
+  m_regs_timing = NULL;
+  m_II = 1;
+
+  m_disabled = t_node->m_disabled;
+  m_canReturn = t_node->m_canReturn;
+  m_canStore = t_node->m_canStore;
+  m_canLoad = t_node->m_canLoad;
+  m_canAdd = t_node->m_canAdd;
+  m_canMul = t_node->m_canMul;
+  m_canShift = t_node->m_canShift;
+  m_canPhi = t_node->m_canPhi;
+  m_canSel = t_node->m_canSel;
+  m_canCmp = t_node->m_canCmp;
+  m_canMAC = t_node->m_canMAC;
+  m_canLogic = t_node->m_canLogic;
+  m_canBr = t_node->m_canBr;
+  m_canDiv = t_node->m_canDiv;
+  m_supportComplex = t_node->m_supportComplex;
+  m_supportVectorization = t_node->m_supportVectorization;
+  m_canCall = t_node->m_canCall;
+  m_supportComplexType = t_node->m_supportComplexType;
+
+  m_supportDVFS = t_node->m_supportDVFS;
+  m_DVFSIslandX = t_node->m_DVFSIslandX;
+  m_DVFSIslandY = t_node->m_DVFSIslandY;
+  m_DVFSIslandId = t_node->m_DVFSIslandId;
+  m_canMultipleOps = t_node->m_canMultipleOps;
+  m_journal = NULL;
+
+  copyMRRG(t_node);
+}
+
+CGRANode::~CGRANode() {
+  deleteRegs();
+}
+
+// Takes over the mapping state of the same tile on another CGRA, i.e.,
+// the reservations, the registers and the DVFS level.
+void CGRANode::copyMRRG(CGRANode* t_node) {
+  deleteRegs();
+  m_II = t_node->m_II;
+  m_cycleBoundary = t_node->m_cycleBoundary;
+  m_currentCtrlMemItems = t_node->m_currentCtrlMemItems;
+  m_registers = t_node->m_registers;
+  m_slotStatus = t_node->m_slotStatus;
+  m_slotOccupancy = t_node->m_slotOccupancy;
+  if (t_node->m_regs_duration != NULL) {
+    m_regs_duration = new int*[m_II];
+    m_regs_timing = new int*[m_II];
+    for (int i=0; i<m_II; ++i) {
+      m_regs_duration[i] = new int[m_registerCount];
+      m_regs_timing[i] = new int[m_registerCount];
+      for (int j=0; j<m_registerCount; ++j) {
+        m_regs_duration[i][j] = t_node->m_regs_duration[i][j];
+        m_regs_timing[i][j] = t_node->m_regs_timing[i][j];
+      }
+    }
+  }
+  m_DVFSLatencyMultiple = t_node->m_DVFSLatencyMultiple;
+  m_mapped = t_node->m_mapped;
+  m_synced = t_node->m_synced;
+}
+
+// The DVFS level and the mapped/synced flags are not recorded, as they are
+// not reset by constructMRRG() either.
+void CGRANode::setJournal(MappingJournal* t_journal) {
+  m_journal = t_journal;
+}
+
+void CGRANode::deleteRegs() {
+  if (m_regs_duration != NULL) {
+    for (int i=0; i<m_II; ++i) {
+      delete[] m_regs_duration[i];
+      delete[] m_regs_timing[i];
+    }
+    delete[] m_regs_duration;
+    delete[] m_regs_timing;
+  }
+  m_regs_duration = NULL;
+  m_regs_timing = NULL;
 }
 
 // FIXME: should handle the case that the data is maintained in the registers
@@ -80,47 +172,53 @@ void CGRANode::allocateReg(CGRALink* t_link, int t_cycle, int t_duration, int t_
 
 void CGRANode::allocateReg(int t_port_id, int t_cycle, int t_duration, int t_II) {
   bool allocated = false;
+  // The register is held every t_II cycles, which covers one or all the
+  // modulo slots.
   for (int i=0; i<m_registerCount; ++i) {
     bool reg_occupied = false;
-    for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-      for (int d=0; d<t_duration; ++d) {
-        if (cycle+d<m_cycleBoundary and m_regs_duration[cycle+d][i] != -1)
-          reg_occupied = true;
-      }
-    }
-    for (int cycle=t_cycle; cycle>=0; cycle-=t_II) {
+    for (int slot=t_cycle%t_II; slot<m_II; slot+=t_II) {
       for (int d=0; d<t_duration; ++d) {
-        if (m_regs_duration[cycle+d][i] != -1)
+        if (m_regs_duration[(slot+d)%m_II][i] != -1)
           reg_occupied = true;
       }
     }
     if (reg_occupied == false) {
-      cout<<"[DEBUG] in allocateReg() t_cycle: "<<t_cycle<<"; i: "<<i<<" CGRA node: "<<this->getID()<<"; link: "<<t_port_id<<" duration "<<t_duration<<"\n";
-      for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-        m_regs_timing[cycle][i] = t_port_id;
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] in allocateReg() t_cycle: "<<t_cycle<<"; i: "<<i<<" CGRA node: "<<this->getID()<<"; link: "<<t_port_id<<" duration "<<t_duration<<"\n";
+      for (int slot=t_cycle%t_II; slot<m_II; slot+=t_II) {
+        if (m_journal != NULL)
+          m_journal->recordInt(&m_regs_timing[slot][i]);
+        m_regs_timing[slot][i] = t_port_id;
         for (int d=0; d<t_duration; ++d) {
-          if (cycle+d<m_cycleBoundary) {
-            // assert(m_regs_duration[cycle+d][i] == -1);
-            m_regs_duration[cycle+d][i] = t_port_id;
-          }
-        }
-      }
-      for (int cycle=t_cycle; cycle>=0; cycle-=t_II) {
-        m_regs_timing[cycle][i] = t_port_id;
-        for (int d=0; d<t_duration; ++d) {
-          m_regs_duration[cycle+d][i] = t_port_id;
+          // assert(m_regs_duration[(slot+d)%m_II][i] == -1);
+          if (m_journal != NULL)
+            m_journal->recordInt(&m_regs_duration[(slot+d)%m_II][i]);
+          m_regs_duration[(slot+d)%m_II][i] = t_port_id;
         }
       }
       allocated = true;
       break;
     }
   }
-  cout<<"[DEBUG] done reg allocation"<<endl;
+  LOG(LOG_LEVEL_TRACE)<<"[DEBUG] done reg allocation\n";
   //assert(allocated);
 }
 
 int* CGRANode::getRegsAllocation(int t_cycle) {
-  return m_regs_timing[t_cycle];
+  return m_regs_timing[getSlot(t_cycle)];
+}
+
+// Number of the (slot, register) pairs that are held by some data.
+int CGRANode::getOccupiedRegisterCount() {
+  if (m_regs_duration == NULL)
+    return 0;
+  int count = 0;
+  for (int slot=0; slot<m_II; ++slot) {
+    for (int i=0; i<m_registerCount; ++i) {
+      if (m_regs_duration[slot][i] != -1)
+        ++count;
+    }
+  }
+  return count;
 }
 
 void CGRANode::setCtrlMemConstraint(int t_ctrlMemConstraint) {
@@ -199,34 +297,36 @@ list<CGRALink*>* CGRANode::getOutLinks() {
   return &m_outLinks;
 }
 
-list<CGRANode*>* CGRANode::getNeighbors() {
-  if (m_neighbors != NULL)
-    return m_neighbors;
-  m_neighbors = new list<CGRANode*>();
+// Collects the neighbors once all the links are connected, so that the
+// neighbors can be queried concurrently.
+void CGRANode::collectNeighbors() {
+  m_neighbors.clear();
   for (CGRALink* link: m_outLinks)
-    m_neighbors->push_back(link->getConnectedNode(this));
-  return m_neighbors;
+    m_neighbors.push_back(link->getConnectedNode(this));
+}
+
+list<CGRANode*>* CGRANode::getNeighbors() {
+  return &m_neighbors;
 }
 
 void CGRANode::constructMRRG(int t_CGRANodeCount, int t_II) {
+  // Delete the register tables of the previous II to avoid memory leakage.
+  deleteRegs();
+
+  m_II = t_II;
   m_cycleBoundary = t_CGRANodeCount*t_II*t_II;
   m_currentCtrlMemItems = 0;
   m_registers.clear();
-  // Delete all these local arrays to avoid memory leakage.
-  if (m_dfgNodesWithOccupyStatus.size() > 0) {
-    for (list<pair<DFGNode*, int>>* opts: m_dfgNodesWithOccupyStatus) {
-      opts->clear();
-    }
-  }
-  m_dfgNodesWithOccupyStatus.clear();
-  // m_dfgNodesWithOccupyStatus = new list<list<pair<DFGNode*, int>>*>();
-  for (int i=0; i<m_cycleBoundary; ++i) {
-    m_dfgNodesWithOccupyStatus.push_back(new list<pair<DFGNode*, int>>());
-  }
 
-  m_regs_duration = new int*[m_cycleBoundary];
-  m_regs_timing = new int*[m_cycleBoundary];
-  for (int i=0; i<m_cycleBoundary; ++i) {
+  // The occupancy is periodic in II, so a modulo reservation table with
+  // one slot per cycle within II is enough.
+  int words = (t_II + 63) / 64;
+  m_slotStatus.assign(4, vector<unsigned long long>(words, 0));
+  m_slotOccupancy.assign(t_II, vector<ModuloOccupancy>());
+
+  m_regs_duration = new int*[t_II];
+  m_regs_timing = new int*[t_II];
+  for (int i=0; i<t_II; ++i) {
     m_regs_duration[i] = new int[m_registerCount];
     m_regs_timing[i] = new int[m_registerCount];
     for (int j=0; j<m_registerCount; ++j) {
@@ -234,6 +334,54 @@ void CGRANode::constructMRRG(int t_CGRANodeCount, int t_II) {
       m_regs_timing[i][j] = -1;
     }
   }
+  addStatsCount(STATS_MRRG_BYTES,
+      4 * words * sizeof(unsigned long long) +
+      t_II * (sizeof(vector<ModuloOccupancy>) +
+              2 * (sizeof(int*) + m_registerCount * sizeof(int))));
+}
+
+int CGRANode::getSlot(int t_cycle) {
+  return (t_cycle%m_II + m_II) % m_II;
+}
+
+bool CGRANode::hasStatus(int t_slot, int t_status) {
+  return (m_slotStatus[t_status][t_slot/64] >> (t_slot%64)) & 1;
+}
+
+bool CGRANode::isSlotEmpty(int t_slot) {
+  return !hasStatus(t_slot, SINGLE_OCCUPY) and
+         !hasStatus(t_slot, START_PIPE_OCCUPY) and
+         !hasStatus(t_slot, END_PIPE_OCCUPY) and
+         !hasStatus(t_slot, IN_PIPE_OCCUPY);
+}
+
+// Checks whether the occupancy recurs at any cycle within [t_low, t_high].
+bool CGRANode::recursWithin(ModuloOccupancy& t_occupancy, int t_low, int t_high) {
+  int low = max(t_occupancy.firstCycle, t_low);
+  // Aligns to the first recurrence that is not earlier than 'low'.
+  low = t_occupancy.firstCycle +
+        (low - t_occupancy.firstCycle + m_II - 1) / m_II * m_II;
+  return low <= min(t_occupancy.lastCycle, t_high);
+}
+
+// Records the FU is occupied with the given status every II cycles
+// starting from t_firstCycle until the end of the MRRG.
+void CGRANode::occupySlot(DFGNode* t_opt, int t_status, int t_firstCycle) {
+  if (t_firstCycle >= m_cycleBoundary)
+    return;
+  ModuloOccupancy occupancy;
+  occupancy.dfgNode = t_opt;
+  occupancy.status = t_status;
+  occupancy.firstCycle = t_firstCycle;
+  occupancy.lastCycle = t_firstCycle +
+      (m_cycleBoundary - 1 - t_firstCycle) / m_II * m_II;
+  int slot = getSlot(t_firstCycle);
+  if (m_journal != NULL) {
+    m_journal->recordOccupancy(&m_slotOccupancy[slot]);
+    m_journal->recordWord(&m_slotStatus[t_status][slot/64]);
+  }
+  m_slotOccupancy[slot].push_back(occupancy);
+  m_slotStatus[t_status][slot/64] |= 1ULL << (slot%64);
 }
 
 bool CGRANode::canSupport(DFGNode* t_opt) {
@@ -295,77 +443,92 @@ bool CGRANode::canOccupy(DFGNode* t_opt, int t_cycle, int t_II) {
   }
 
   // Handle multi-cycle execution and pipelinable operations.
+  int slot = getSlot(t_cycle);
   if (not t_opt->isMultiCycleExec(getDVFSLatencyMultiple())) {
     // Single-cycle opt:
-    for (int cycle=t_cycle%t_II; cycle<m_cycleBoundary; cycle+=t_II) {
-      // If this tile don't support inclusive execution (canMultipleOps() == false), and there has been an operation occupied this tile at the current cycle, we cannot map t_opt on it. 
-      if (!canMultipleOps() && !m_dfgNodesWithOccupyStatus[cycle]->empty()) {
-        return false;
-      }
-      for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle])) {
-        if (p.second != IN_PIPE_OCCUPY) {
-          return false;
-        }
-      }
+    // If this tile don't support inclusive execution (canMultipleOps() == false), and there has been an operation occupied this tile at the current cycle, we cannot map t_opt on it. 
+    if (!canMultipleOps() && !isSlotEmpty(slot)) {
+      return false;
+    }
+    if (hasStatus(slot, SINGLE_OCCUPY) or
+        hasStatus(slot, START_PIPE_OCCUPY) or
+        hasStatus(slot, END_PIPE_OCCUPY)) {
+      return false;
     }
   } else {
     // Multi-cycle opt.
-    for (int cycle=t_cycle%t_II; cycle<m_cycleBoundary; cycle+=t_II) {
-      // Can not support simultaneous execution of multiple operations.
-      if (!canMultipleOps()) {
-        int exec_latency = t_opt->getExecLatency(getDVFSLatencyMultiple());
-        for (int duration=0; duration < exec_latency; duration++) {
-          if (cycle + duration >= m_cycleBoundary) {
-            break;
-          }
-          if (!m_dfgNodesWithOccupyStatus[cycle+duration]->empty()) {
+    int startCycle = t_cycle%t_II;
+    int execLatency = t_opt->getExecLatency(getDVFSLatencyMultiple());
+    // Can not support simultaneous execution of multiple operations.
+    if (!canMultipleOps()) {
+      for (int duration=0; duration < execLatency; duration++) {
+        int durationSlot = getSlot(startCycle + duration);
+        if (isSlotEmpty(durationSlot)) {
+          continue;
+        }
+        for (ModuloOccupancy& o: m_slotOccupancy[durationSlot]) {
+          if (recursWithin(o, startCycle + duration, m_cycleBoundary - 1)) {
             return false;
           }
         }
       }
-      else {
-        // Check start cycle.
-        for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle])) {
-          // Cannot occupy/overlap by/with other operation if DVFS is enabled.
-          if (isDVFSEnabled() and
-              (p.second == SINGLE_OCCUPY or
-              p.second == START_PIPE_OCCUPY or
-              p.second == IN_PIPE_OCCUPY or
-              p.second == END_PIPE_OCCUPY)) {
-            return false;
-          }
-          // Multi-cycle opt's start cycle overlaps with single-cycle opt' cycle.
-          else if (p.second == SINGLE_OCCUPY) {
-            return false;
-          }
-          // Multi-cycle opt's start cycle overlaps with multi-cycle opt's start cycle.
-          else if (p.second == START_PIPE_OCCUPY) {
-            return false;
-          }
-          // Multi-cycle opt's start cycle overlaps with multi-cycle opt with the same type:
-          else if ((p.second == IN_PIPE_OCCUPY or p.second == END_PIPE_OCCUPY) and
-                  (t_opt->shareFU(p.first))   and
-                  (not t_opt->isPipelinable() or not p.first->isPipelinable())) {
-            return false;
-          }
+    }
+    else {
+      // The start cycles are checked until the end cycle of an iteration
+      // exceeds the MRRG.
+      int endCycle = startCycle + execLatency - 1;
+      int lastStartCycle = startCycle;
+      if (endCycle < m_cycleBoundary) {
+        lastStartCycle += (m_cycleBoundary - endCycle + t_II - 1) / t_II * t_II;
+      }
+      lastStartCycle = min(lastStartCycle, m_cycleBoundary - 1);
+
+      // Check start cycle.
+      for (ModuloOccupancy& o: m_slotOccupancy[slot]) {
+        if (!recursWithin(o, startCycle, lastStartCycle)) {
+          continue;
+        }
+        // Cannot occupy/overlap by/with other operation if DVFS is enabled.
+        if (isDVFSEnabled() and
+            (o.status == SINGLE_OCCUPY or
+            o.status == START_PIPE_OCCUPY or
+            o.status == IN_PIPE_OCCUPY or
+            o.status == END_PIPE_OCCUPY)) {
+          return false;
         }
-        if (cycle+t_opt->getExecLatency(getDVFSLatencyMultiple())-1 >= m_cycleBoundary) {
-          break;
+        // Multi-cycle opt's start cycle overlaps with single-cycle opt' cycle.
+        else if (o.status == SINGLE_OCCUPY) {
+          return false;
+        }
+        // Multi-cycle opt's start cycle overlaps with multi-cycle opt's start cycle.
+        else if (o.status == START_PIPE_OCCUPY) {
+          return false;
+        }
+        // Multi-cycle opt's start cycle overlaps with multi-cycle opt with the same type:
+        else if ((o.status == IN_PIPE_OCCUPY or o.status == END_PIPE_OCCUPY) and
+                (t_opt->shareFU(o.dfgNode))   and
+                (not t_opt->isPipelinable() or not o.dfgNode->isPipelinable())) {
+          return false;
         }
-        // Check end cycle.
-        for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle+t_opt->getExecLatency(getDVFSLatencyMultiple())-1])) {
+      }
+      // Check end cycle.
+      if (endCycle < m_cycleBoundary) {
+        for (ModuloOccupancy& o: m_slotOccupancy[getSlot(endCycle)]) {
+          if (!recursWithin(o, endCycle, m_cycleBoundary - 1)) {
+            continue;
+          }
           // Multi-cycle opt's end cycle overlaps with single-cycle opt' cycle.
-          if (p.second == SINGLE_OCCUPY) {
+          if (o.status == SINGLE_OCCUPY) {
             return false;
           }
           // Multi-cycle opt's end cycle overlaps with multi-cycle opt's end cycle.
-          else if (p.second == END_PIPE_OCCUPY) {
+          else if (o.status == END_PIPE_OCCUPY) {
             return false;
           }
           // Multi-cycle opt's end cycle overlaps with multi-cycle opt with the same type:
-          else if ((p.second == IN_PIPE_OCCUPY or p.second == START_PIPE_OCCUPY) and
-                  (t_opt->shareFU(p.first))   and
-                  (not t_opt->isPipelinable() or not p.first->isPipelinable())) {
+          else if ((o.status == IN_PIPE_OCCUPY or o.status == START_PIPE_OCCUPY) and
+                  (t_opt->shareFU(o.dfgNode))   and
+                  (not t_opt->isPipelinable() or not o.dfgNode->isPipelinable())) {
             return false;
           }
         }
@@ -377,46 +540,50 @@ bool CGRANode::canOccupy(DFGNode* t_opt, int t_cycle, int t_II) {
 }
 
 bool CGRANode::isOccupied(int t_cycle, int t_II) {
-  for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-    for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle])) {
-      // If DVFS is supported, the entire tile is occupied before the current multi-cycle operation
-      // completes. Otherwise, the next operation can start before the current one completes.
-      if (p.second == START_PIPE_OCCUPY or p.second == SINGLE_OCCUPY or m_supportDVFS) {
-        return true;
-      }
+  if (t_cycle >= m_cycleBoundary)
+    return false;
+  for (ModuloOccupancy& o: m_slotOccupancy[getSlot(t_cycle)]) {
+    // If DVFS is supported, the entire tile is occupied before the current multi-cycle operation
+    // completes. Otherwise, the next operation can start before the current one completes.
+    if ((o.status == START_PIPE_OCCUPY or o.status == SINGLE_OCCUPY or m_supportDVFS) and
+        recursWithin(o, t_cycle, m_cycleBoundary - 1)) {
+      return true;
     }
   }
   return false;
 }
 
 bool CGRANode::isStartOrInPipe(int t_cycle, int t_II) {
-  for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-    for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle])) {
-      if (p.second == START_PIPE_OCCUPY or p.second == IN_PIPE_OCCUPY) {
-        return true;
-      }
+  if (t_cycle >= m_cycleBoundary)
+    return false;
+  for (ModuloOccupancy& o: m_slotOccupancy[getSlot(t_cycle)]) {
+    if ((o.status == START_PIPE_OCCUPY or o.status == IN_PIPE_OCCUPY) and
+        recursWithin(o, t_cycle, m_cycleBoundary - 1)) {
+      return true;
     }
   }
   return false;
 }
 
 bool CGRANode::isInOrEndPipe(int t_cycle, int t_II) {
-  for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-    for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle])) {
-      if (p.second == IN_PIPE_OCCUPY or p.second == END_PIPE_OCCUPY) {
-        return true;
-      }
+  if (t_cycle >= m_cycleBoundary)
+    return false;
+  for (ModuloOccupancy& o: m_slotOccupancy[getSlot(t_cycle)]) {
+    if ((o.status == IN_PIPE_OCCUPY or o.status == END_PIPE_OCCUPY) and
+        recursWithin(o, t_cycle, m_cycleBoundary - 1)) {
+      return true;
     }
   }
   return false;
 }
 
 bool CGRANode::isEndPipe(int t_cycle, int t_II) {
-  for (int cycle=t_cycle; cycle<m_cycleBoundary; cycle+=t_II) {
-    for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[cycle])) {
-      if (p.second == END_PIPE_OCCUPY) {
-        return true;
-      }
+  if (t_cycle >= m_cycleBoundary)
+    return false;
+  for (ModuloOccupancy& o: m_slotOccupancy[getSlot(t_cycle)]) {
+    if (o.status == END_PIPE_OCCUPY and
+        recursWithin(o, t_cycle, m_cycleBoundary - 1)) {
+      return true;
     }
   }
   return false;
@@ -446,41 +613,42 @@ void CGRANode::setDFGNode(DFGNode* t_opt, int t_cycle, int t_II,
       setDVFSLatencyMultiple(t_opt->getDVFSLatencyMultiple());
     }
   }
-  for (int cycle=t_cycle%interval; cycle<m_cycleBoundary; cycle+=interval) {
+  // The static elastic CGRA repeats the opt every cycle, which occupies
+  // all the modulo slots.
+  for (int cycle=t_cycle%interval; cycle<t_II and cycle<m_cycleBoundary; cycle+=interval) {
     if (not t_opt->isMultiCycleExec(getDVFSLatencyMultiple())) {
-      m_dfgNodesWithOccupyStatus[cycle]->push_back(make_pair(t_opt, SINGLE_OCCUPY));
+      occupySlot(t_opt, SINGLE_OCCUPY, cycle);
     } else {
-      m_dfgNodesWithOccupyStatus[cycle]->push_back(make_pair(t_opt, START_PIPE_OCCUPY));
+      occupySlot(t_opt, START_PIPE_OCCUPY, cycle);
       for (int i=1; i<t_opt->getExecLatency(getDVFSLatencyMultiple())-1; ++i) {
-        if (cycle+i < m_cycleBoundary) {
-          m_dfgNodesWithOccupyStatus[cycle+i]->push_back(make_pair(t_opt, IN_PIPE_OCCUPY));
-        }
+        occupySlot(t_opt, IN_PIPE_OCCUPY, cycle+i);
       }
       int lastCycle = cycle+t_opt->getExecLatency(getDVFSLatencyMultiple())-1;
-      if (lastCycle < m_cycleBoundary) {
-        m_dfgNodesWithOccupyStatus[lastCycle]->push_back(make_pair(t_opt, END_PIPE_OCCUPY));
-      }
+      occupySlot(t_opt, END_PIPE_OCCUPY, lastCycle);
     }
   }
 
-  cout<<"[DEBUG] setDFGNode "<<t_opt->getID()<<" onto CGRANode "<<getID()<<" at cycle: "<<t_cycle<<"\n";
+  LOG(LOG_LEVEL_TRACE)<<"[DEBUG] setDFGNode "<<t_opt->getID()<<" onto CGRANode "<<getID()<<" at cycle: "<<t_cycle<<"\n";
+  if (m_journal != NULL)
+    m_journal->recordInt(&m_currentCtrlMemItems);
   ++m_currentCtrlMemItems;
   t_opt->setMapped();
 }
 
 DFGNode* CGRANode::getMappedDFGNode(int t_cycle) {
-  for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[t_cycle])) {
-    if (p.second == SINGLE_OCCUPY or p.second == END_PIPE_OCCUPY) {
-      return p.first;
+  for (ModuloOccupancy& o: m_slotOccupancy[getSlot(t_cycle)]) {
+    if ((o.status == SINGLE_OCCUPY or o.status == END_PIPE_OCCUPY) and
+        recursWithin(o, t_cycle, t_cycle)) {
+      return o.dfgNode;
     }
   }
   return NULL;
 }
 
 bool CGRANode::containMappedDFGNode(DFGNode* t_node, int t_II) {
-  for (int c=0; c<2*t_II; ++c) {
-    for (pair<DFGNode*, int> p: *(m_dfgNodesWithOccupyStatus[c])) {
-      if (t_node == p.first) {
+  for (vector<ModuloOccupancy>& occupancies: m_slotOccupancy) {
+    for (ModuloOccupancy& o: occupancies) {
+      if (t_node == o.dfgNode and recursWithin(o, 0, 2*t_II-1)) {
         return true;
       }
     }
@@ -497,28 +665,24 @@ void CGRANode::addRegisterValue(float t_value) {
   m_registers.push_back(t_value);
 }
 
-list<CGRALink*>* CGRANode::getOccupiableInLinks(int t_cycle, int t_II) {
-  if (m_occupiableInLinks == NULL)
-    m_occupiableInLinks = new list<CGRALink*>();
-  m_occupiableInLinks->clear();
+list<CGRALink*> CGRANode::getOccupiableInLinks(int t_cycle, int t_II) {
+  list<CGRALink*> occupiableInLinks;
   for (CGRALink* link: m_inLinks) {
     if (link->canOccupy(t_cycle, t_II)) {
-      m_occupiableInLinks->push_back(link);
+      occupiableInLinks.push_back(link);
     }
   }
-  return m_occupiableInLinks;
+  return occupiableInLinks;
 }
 
-list<CGRALink*>* CGRANode::getOccupiableOutLinks(int t_cycle, int t_II) {
-  if (m_occupiableOutLinks == NULL)
-    m_occupiableOutLinks = new list<CGRALink*>();
-  m_occupiableOutLinks->clear();
+list<CGRALink*> CGRANode::getOccupiableOutLinks(int t_cycle, int t_II) {
+  list<CGRALink*> occupiableOutLinks;
   for (CGRALink* link: m_outLinks) {
     if (link->canOccupy(t_cycle, t_II)) {
-      m_occupiableOutLinks->push_back(link);
+      occupiableOutLinks.push_back(link);
     }
   }
-  return m_occupiableOutLinks;
+  return occupiableOutLinks;
 }
 
 int CGRANode::getAvailableRegisterCount() {
@@ -664,7 +828,7 @@ void CGRANode::enableDiv() {
 }
 
 void CGRANode::disableMultipleOps() {
-  printf("disabling multiple ops\n");
+  LOG(LOG_LEVEL_DEBUG)<<"disabling multiple ops\n";
   m_canMultipleOps = false;
 }
 
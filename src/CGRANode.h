@@ -13,6 +13,7 @@
 
 #include "CGRALink.h"
 #include "DFGNode.h"
+#include "MappingJournal.h"
 #include <iostream>
 //#include <llvm/IR/Function.h>
 //#include <llvm/IR/Value.h>
@@ -28,6 +29,15 @@ using namespace llvm;
 class CGRALink;
 class DFGNode;
 
+// The FU is occupied by the DFG node with the given status every II
+// cycles from the first cycle to the last cycle within the MRRG.
+struct ModuloOccupancy {
+  DFGNode* dfgNode;
+  int status;
+  int firstCycle;
+  int lastCycle;
+};
+
 class CGRANode {
 
   private:
@@ -42,11 +52,10 @@ class CGRANode {
     float* m_ctrlMem;
     list<CGRALink*> m_inLinks;
     list<CGRALink*> m_outLinks;
-    list<CGRALink*>* m_occupiableInLinks;
-    list<CGRALink*>* m_occupiableOutLinks;
-    list<CGRANode*>* m_neighbors;
+    list<CGRANode*> m_neighbors;
 
     // functional unit occupied with cycle going on
+    int m_II;
     int m_cycleBoundary;
     int* m_fuOccupied;
     DFGNode** m_dfgNodes;
@@ -69,7 +78,10 @@ class CGRANode {
     bool m_supportVectorization;
     int** m_regs_duration;
     int** m_regs_timing;
-    vector<list<pair<DFGNode*, int>>*> m_dfgNodesWithOccupyStatus;
+    // Modulo reservation table of the FU: a bitset over the II slots for
+    // each occupy status, along with the occupancies within each slot.
+    vector<vector<unsigned long long>> m_slotStatus;
+    vector<vector<ModuloOccupancy>> m_slotOccupancy;
     vector<string> m_canCall;
     vector<string> m_supportComplexType;
 
@@ -84,8 +96,20 @@ class CGRANode {
 
     bool m_canMultipleOps;
 
+    // Records the changes of the MRRG if it is not NULL.
+    MappingJournal* m_journal;
+
+    int getSlot(int);
+    bool hasStatus(int, int);
+    bool isSlotEmpty(int);
+    bool recursWithin(ModuloOccupancy&, int, int);
+    void occupySlot(DFGNode*, int, int);
+    void deleteRegs();
+
   public:
     CGRANode(int, int, int);
+    CGRANode(CGRANode*);
+    ~CGRANode();
 //    CGRANode(int, int, int, int, int);
     void setRegConstraint(int);
     void setCtrlMemConstraint(int);
@@ -123,9 +147,12 @@ class CGRANode {
     list<CGRALink*>* getOutLinks();
     CGRALink* getInLink(CGRANode*);
     CGRALink* getOutLink(CGRANode*);
+    void collectNeighbors();
     list<CGRANode*>* getNeighbors();
 
     void constructMRRG(int, int);
+    void copyMRRG(CGRANode*);
+    void setJournal(MappingJournal*);
     bool canSupport(DFGNode*);
     bool isOccupied(int, int);
     // bool canOccupy(int, int);
@@ -133,8 +160,8 @@ class CGRANode {
     void setDFGNode(DFGNode*, int, int, bool);
     void configXbar(CGRALink*, int, int);
     void addRegisterValue(float);
-    list<CGRALink*>* getOccupiableInLinks(int, int);
-    list<CGRALink*>* getOccupiableOutLinks(int, int);
+    list<CGRALink*> getOccupiableInLinks(int, int);
+    list<CGRALink*> getOccupiableOutLinks(int, int);
     int getAvailableRegisterCount();
     int getMinIdleCycle(DFGNode*, int, int);
     int getCurrentCtrlMemItems();
@@ -162,6 +189,7 @@ class CGRANode {
     void allocateReg(CGRALink*, int, int, int);
     void allocateReg(int, int, int, int);
     int* getRegsAllocation(int);
+    int getOccupiedRegisterCount();
     void disable();
     bool isDisabled();
     void disableAllFUs();
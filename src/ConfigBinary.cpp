@@ -0,0 +1,202 @@
+/*
+ * ======================================================================
+ * ConfigBinary.cpp
+ * ======================================================================
+ * Binary configuration (config.bin) writer and reader implementation.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include "ConfigBinary.h"
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Adds the configuration of the tile (t_x, t_y) at t_cycle, whose outputs
+// are given as in config.json, i.e., "none" or the feeding port.
+bool ConfigBinaryWriter::addRecord(int t_x, int t_y, int t_cycle,
+                                   string t_opcode, bool t_predicate,
+                                   vector<int>& t_predicateIn, string* t_out) {
+  if (t_predicateIn.size() > CONFIG_BINARY_MAX_PREDICATE_IN) {
+    m_error = "too many predicate inputs at tile (" + to_string(t_x) + ", " +
+              to_string(t_y) + ")";
+    return false;
+  }
+  if (m_opcodeIDs.find(t_opcode) == m_opcodeIDs.end()) {
+    m_opcodeIDs[t_opcode] = m_opcodes.size();
+    m_opcodes.push_back(t_opcode);
+  }
+  ConfigBinaryRecord record;
+  memset(&record, 0, sizeof(record));
+  record.x = t_x;
+  record.y = t_y;
+  record.cycle = t_cycle;
+  record.opcode = m_opcodeIDs[t_opcode];
+  record.predicate = t_predicate;
+  record.predicateInCount = t_predicateIn.size();
+  for (int i=0; i<CONFIG_BINARY_MAX_PREDICATE_IN; ++i) {
+    record.predicateIn[i] = CONFIG_BINARY_NONE;
+  }
+  for (int i=0; i<t_predicateIn.size(); ++i) {
+    record.predicateIn[i] = t_predicateIn[i];
+  }
+  for (int i=0; i<CONFIG_BINARY_OUTPUTS; ++i) {
+    if (t_out[i] == "none") {
+      record.out[i] = CONFIG_BINARY_NONE;
+    } else {
+      record.out[i] = stoi(t_out[i]);
+    }
+  }
+  m_records.push_back(record);
+  return true;
+}
+
+bool ConfigBinaryWriter::write(string t_fileName, int t_rows, int t_columns,
+                               int t_II) {
+  // A record that could not be added leaves the configuration incomplete.
+  if (m_error != "")
+    return false;
+  if (t_rows > UINT16_MAX or t_columns > UINT16_MAX or t_II > UINT16_MAX or
+      m_opcodes.size() > UINT16_MAX) {
+    m_error = "the configuration exceeds the binary format";
+    return false;
+  }
+  // The opcode names are padded to a multiple of 8 bytes with at least one
+  // NUL, which keeps the records 8-byte aligned.
+  int opcodeLength = 8;
+  for (string opcode: m_opcodes) {
+    while (opcodeLength < opcode.size() + 1) {
+      opcodeLength += 8;
+    }
+  }
+  ConfigBinaryHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CONFIG_BINARY_MAGIC, 4);
+  header.version = CONFIG_BINARY_VERSION;
+  header.recordSize = sizeof(ConfigBinaryRecord);
+  header.rows = t_rows;
+  header.columns = t_columns;
+  header.II = t_II;
+  header.opcodeLength = opcodeLength;
+  header.opcodeCount = m_opcodes.size();
+  header.recordCount = m_records.size();
+  header.opcodeOffset = sizeof(header);
+  header.recordOffset = header.opcodeOffset + opcodeLength*m_opcodes.size();
+
+  ofstream binaryFile(t_fileName, ios::out | ios::binary);
+  if (!binaryFile.good()) {
+    m_error = "cannot write " + t_fileName;
+    return false;
+  }
+  binaryFile.write((char*)&header, sizeof(header));
+  vector<char> opcodeTable(opcodeLength*m_opcodes.size(), 0);
+  for (int i=0; i<m_opcodes.size(); ++i) {
+    memcpy(&opcodeTable[i*opcodeLength], m_opcodes[i].data(),
+           m_opcodes[i].size());
+  }
+  binaryFile.write(opcodeTable.data(), opcodeTable.size());
+  binaryFile.write((char*)m_records.data(),
+                   m_records.size()*sizeof(ConfigBinaryRecord));
+  return binaryFile.good();
+}
+
+string ConfigBinaryWriter::getError() {
+  return m_error;
+}
+
+ConfigBinaryReader::ConfigBinaryReader() {
+  m_fd = -1;
+  m_data = NULL;
+  m_size = 0;
+  m_header = NULL;
+}
+
+ConfigBinaryReader::~ConfigBinaryReader() {
+  close();
+}
+
+// Maps the file and checks its header and sections against its size.
+bool ConfigBinaryReader::open(string t_fileName) {
+  close();
+  m_fd = ::open(t_fileName.c_str(), O_RDONLY);
+  if (m_fd < 0) {
+    m_error = "cannot open " + t_fileName;
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(m_fd, &fileStat) != 0 or
+      fileStat.st_size < sizeof(ConfigBinaryHeader)) {
+    m_error = t_fileName + " is not a binary configuration";
+    close();
+    return false;
+  }
+  m_size = fileStat.st_size;
+  void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  if (data == MAP_FAILED) {
+    m_error = "cannot map " + t_fileName;
+    m_size = 0;
+    close();
+    return false;
+  }
+  m_data = (char*)data;
+  m_header = (ConfigBinaryHeader*)m_data;
+  if (memcmp(m_header->magic, CONFIG_BINARY_MAGIC, 4) != 0) {
+    m_error = t_fileName + " is not a binary configuration";
+  } else if (m_header->version != CONFIG_BINARY_VERSION) {
+    m_error = t_fileName + " has an unsupported version " +
+              to_string(m_header->version);
+  } else if (m_header->recordSize != sizeof(ConfigBinaryRecord)) {
+    m_error = t_fileName + " has an unexpected record size";
+  } else if (m_header->opcodeOffset + (size_t)m_header->opcodeLength *
+             m_header->opcodeCount > m_size or
+             m_header->recordOffset + (size_t)m_header->recordSize *
+             m_header->recordCount > m_size) {
+    m_error = t_fileName + " is truncated";
+  } else {
+    return true;
+  }
+  close();
+  return false;
+}
+
+void ConfigBinaryReader::close() {
+  if (m_data != NULL) {
+    munmap(m_data, m_size);
+  }
+  if (m_fd >= 0) {
+    ::close(m_fd);
+  }
+  m_fd = -1;
+  m_data = NULL;
+  m_size = 0;
+  m_header = NULL;
+}
+
+ConfigBinaryHeader* ConfigBinaryReader::getHeader() {
+  return m_header;
+}
+
+int ConfigBinaryReader::getRecordCount() {
+  return m_header->recordCount;
+}
+
+ConfigBinaryRecord* ConfigBinaryReader::getRecord(int t_index) {
+  return (ConfigBinaryRecord*)(m_data + m_header->recordOffset) + t_index;
+}
+
+// Returns the name of the opcode, or an empty string for an invalid one.
+string ConfigBinaryReader::getOpcode(int t_opcode) {
+  if (t_opcode < 0 or t_opcode >= m_header->opcodeCount)
+    return "";
+  char* name = m_data + m_header->opcodeOffset +
+               (size_t)t_opcode*m_header->opcodeLength;
+  return string(name, strnlen(name, m_header->opcodeLength));
+}
+
+string ConfigBinaryReader::getError() {
+  return m_error;
+}
@@ -0,0 +1,103 @@
+/*
+ * ======================================================================
+ * ConfigBinary.h
+ * ======================================================================
+ * Binary configuration (config.bin) writer and reader header file, which
+ * has no dependency on the mapper so that simulators can use it as is.
+ *
+ * The file (little-endian) is laid out as:
+ *   ConfigBinaryHeader (32 bytes)
+ *   opcodeCount x opcodeLength bytes of NUL-padded opcode names
+ *   recordCount x ConfigBinaryRecord (32 bytes), at recordOffset
+ * The records follow the order of config.json, i.e., by cycle, row and
+ * column. The ports are the direction IDs used in config.json (0: N,
+ * 1: S, 2: W, 3: E, 4: the function unit).
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef ConfigBinary_H
+#define ConfigBinary_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define CONFIG_BINARY_MAGIC     "CGRA"
+#define CONFIG_BINARY_VERSION   1
+#define CONFIG_BINARY_NONE      -1 // No port, i.e., "none" in config.json
+#define CONFIG_BINARY_MAX_PREDICATE_IN 14
+#define CONFIG_BINARY_OUTPUTS   8
+
+struct ConfigBinaryHeader {
+  char magic[4];
+  uint16_t version;
+  uint16_t recordSize;
+  uint16_t rows;
+  uint16_t columns;
+  uint16_t II;
+  uint16_t opcodeLength;
+  uint32_t opcodeCount;
+  uint32_t recordCount;
+  uint32_t opcodeOffset;
+  uint32_t recordOffset;
+};
+
+// The configuration of one tile at one cycle. The predicate inputs keep
+// the order of config.json, and out[i] is the port that feeds the output
+// i (i.e., "out_i"), where the outputs 0-3 are the outports and 4-7 are
+// the inputs of the function unit.
+struct ConfigBinaryRecord {
+  uint16_t x;
+  uint16_t y;
+  uint16_t cycle;
+  uint16_t opcode;
+  uint8_t predicate;
+  uint8_t predicateInCount;
+  int8_t predicateIn[CONFIG_BINARY_MAX_PREDICATE_IN];
+  int8_t out[CONFIG_BINARY_OUTPUTS];
+};
+
+static_assert(sizeof(ConfigBinaryHeader) == 32, "unexpected header layout");
+static_assert(sizeof(ConfigBinaryRecord) == 32, "unexpected record layout");
+
+// Collects the records of one configuration and writes them into a file.
+class ConfigBinaryWriter {
+  private:
+    vector<string> m_opcodes;
+    map<string, int> m_opcodeIDs;
+    vector<ConfigBinaryRecord> m_records;
+    string m_error;
+
+  public:
+    bool addRecord(int, int, int, string, bool, vector<int>&, string*);
+    bool write(string, int, int, int);
+    string getError();
+};
+
+// Memory-maps a config.bin, whose records are then accessed in place.
+class ConfigBinaryReader {
+  private:
+    int m_fd;
+    char* m_data;
+    size_t m_size;
+    ConfigBinaryHeader* m_header;
+    string m_error;
+
+  public:
+    ConfigBinaryReader();
+    ~ConfigBinaryReader();
+    bool open(string);
+    void close();
+    ConfigBinaryHeader* getHeader();
+    int getRecordCount();
+    ConfigBinaryRecord* getRecord(int);
+    string getOpcode(int);
+    string getError();
+};
+
+#endif
@@ -10,7 +10,13 @@
  */
 
 #include <fstream>
+#include <sstream>
 #include "DFG.h"
+#include "Logger.h"
+#include "MapperStats.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
 
 DFG::DFG(Function& t_F, list<Loop*>* t_loops, bool t_targetFunction,
          bool t_precisionAware, list<string>* t_fusionStrategy,
@@ -31,6 +37,7 @@ DFG::DFG(Function& t_F, list<Loop*>* t_loops, bool t_targetFunction,
 
   construct(t_F);
   bool needsCycleCalculation = false;
+  ScopedTimer* fusionTimer = new ScopedTimer(STATS_DFG_FUSION);
   for (auto strategy : *t_fusionStrategy) {
     if (strategy == "default_heterogeneous") {
       combine("phi", "add", "Ctrl");
@@ -51,9 +58,10 @@ DFG::DFG(Function& t_F, list<Loop*>* t_loops, bool t_targetFunction,
       needsCycleCalculation = true;
     }
     else {
-      cout << "Error: Unknown strategy '" << strategy << "'\n";
+      LOG(LOG_LEVEL_ERROR) << "Error: Unknown strategy '" << strategy << "'\n";
     }
   }
+  delete fusionTimer;
   if (needsCycleCalculation) {
       calculateCycles();
   }
@@ -65,6 +73,123 @@ DFG::DFG(Function& t_F, list<Loop*>* t_loops, bool t_targetFunction,
   calculateCycles();
 }
 
+// Reads the DFG from the dfg.json generated by the pass (see generateJSON()),
+// whose nodes are already fused (and split by the distributed strategy) and
+// listed in the mapping ordering. Nothing is derived again: the nodes, the
+// edges, the predication, the latencies and the cycles are taken as they
+// were when the pass mapped the DFG.
+DFG::DFG(string t_fileName, bool t_precisionAware, bool t_supportDVFS,
+         bool t_DVFSAwareMapping) {
+  m_num = 0;
+  m_targetFunction = false;
+  m_targetLoops = NULL;
+  m_orderedNodes = NULL;
+  m_CDFGFused = true;
+  m_cycleNodeLists = new list<list<DFGNode*>*>();
+  m_precisionAware = t_precisionAware;
+  m_supportDVFS = t_supportDVFS;
+  m_DVFSAwareMapping = t_DVFSAwareMapping;
+  m_vectorFactorForIdiv = 1;
+
+  // Reading the nodes and edges is timed as the construction.
+  ScopedTimer* constructTimer = new ScopedTimer(STATS_DFG_CONSTRUCT);
+  ifstream jsonFile(t_fileName);
+  json dfgNodes;
+  jsonFile >> dfgNodes;
+  vector<DFGNode*> indexedNodes;
+  for (json& dfgNode: dfgNodes) {
+    DFGNode* node = new DFGNode(dfgNode["id"], t_precisionAware,
+                                dfgNode["opcode"], dfgNode["vectorized"],
+                                dfgNode["phi"], dfgNode["call"],
+                                dfgNode["fu"], dfgNode["JSON_opt"],
+                                dfgNode["in_const"].size(), t_supportDVFS);
+    if (dfgNode["fused"]) {
+      node->setCombine(dfgNode["fused_type"]);
+    }
+    node->setExecLatency(dfgNode["latency"]);
+    if (dfgNode["pipelinable"]) {
+      node->setPipelinable();
+    }
+    if (dfgNode["critical"]) {
+      node->setCritical();
+    }
+    for (int cycleID: dfgNode["cycle_ids"]) {
+      node->addCycleID(cycleID);
+    }
+    nodes.push_back(node);
+    indexedNodes.push_back(node);
+  }
+
+  int edgeID = 0;
+  for (int i=0; i<indexedNodes.size(); ++i) {
+    DFGNode* node = indexedNodes[i];
+    for (json& outEdge: dfgNodes[i]["out_edges"]) {
+      DFGNode* dstNode = indexedNodes[outEdge[0]];
+      DFGEdge* edge = NULL;
+      if (outEdge[1]) {
+        edge = new DFGEdge(edgeID++, node, dstNode, true);
+        addCtrlEdge(edge);
+      } else {
+        edge = new DFGEdge(edgeID++, node, dstNode);
+      }
+      addDFGEdge(edge);
+      node->setOutEdge(edge);
+      dstNode->setInEdge(edge);
+    }
+  }
+
+  // The predecessors, the successors and the predicatees of a node can
+  // differ from its edges (e.g., the ones rewired by the fusion or split by
+  // the distributed strategy), so they are read as they are. The nodes that
+  // are no longer in the DFG are never mapped, so a single node outside the
+  // DFG stands for all of them.
+  DFGNode* removedNode = new DFGNode(-1, t_precisionAware, "", false, false,
+                                     "", "", "", 0, t_supportDVFS);
+  indexedNodes.push_back(removedNode);
+  auto getIndexedNode = [&](int t_index) {
+    return t_index < 0 ? removedNode : indexedNodes[t_index];
+  };
+  for (DFGNode* node: indexedNodes) {
+    node->resetPredication();
+  }
+  for (int i=0; i<dfgNodes.size(); ++i) {
+    DFGNode* node = indexedNodes[i];
+    json& dfgNode = dfgNodes[i];
+    for (int predicateeIndex: dfgNode["predicatees"]) {
+      node->addPredicatee(getIndexedNode(predicateeIndex));
+    }
+    if (dfgNode["predicatee"]) {
+      node->setPredicatee();
+    }
+    node->deleteAllPredNodes();
+    for (int predIndex: dfgNode["pre_index"]) {
+      node->addPredNode(getIndexedNode(predIndex));
+    }
+    node->deleteAllSuccNodes();
+    for (int succIndex: dfgNode["succ_index"]) {
+      node->addSuccNode(getIndexedNode(succIndex));
+    }
+  }
+
+  // The cycles keep the order of the nodes along each of them.
+  vector<vector<DFGNode*>> cycles;
+  for (int i=0; i<dfgNodes.size(); ++i) {
+    for (json& cyclePosition: dfgNodes[i]["cycles"]) {
+      int cycleIndex = cyclePosition[0];
+      if (cycles.size() <= cycleIndex) {
+        cycles.resize(cycleIndex + 1);
+      }
+      cycles[cycleIndex].resize(cyclePosition[2], removedNode);
+      cycles[cycleIndex][cyclePosition[1]] = indexedNodes[i];
+    }
+  }
+  for (vector<DFGNode*>& cycle: cycles) {
+    m_cycleNodeLists->push_back(new list<DFGNode*>(cycle.begin(),
+                                                   cycle.end()));
+  }
+  delete constructTimer;
+}
+
 // Split multi-cycle nodes in the DFG into multiple single-cycle nodes when distributed strategy is adopted.
 // Example: Division takes 8 cycles on our hardware, so each division node in the DFG should be split into 8 sub-nodes, each of which only needs to perform one cycle of division execution.
 // The cycles of the multi-cycle operations are specified by `optLatency` in param.json.
@@ -83,7 +208,7 @@ void DFG::splitNodes() {
         int dfgEdgeID = m_DFGEdges.size();
         DFGEdge* newEdge = new DFGEdge(dfgEdgeID++, nowNode, newNode);
         newNode->setExecLatency(1);
-        m_DFGEdges.push_back(newEdge);
+        addDFGEdge(newEdge);
         // nodes.push_back(newNode);
         add_nodes->push_back(newNode);
         // Update the pred and succ nodes of nods.
@@ -164,9 +289,9 @@ void DFG::initDVFSLatencyMultiple(int t_II, int t_DVFSIslandDim,
       ((high_dvfs_dfg_nodes + num_tiles_in_island - 1) / num_tiles_in_island)) -
       (t_II * num_tiles_in_island *
        ((mid_dvfs_dfg_nodes + num_tiles_in_island - 1) / num_tiles_in_island))) / 4;
-  cout << "[debug] unused_high_dvfs_cgra_tiles_across_II: " << unused_high_dvfs_cgra_tiles_across_II << endl;
-  cout << "[debug] unused_mid_dvfs_cgra_tiles_across_II: " << unused_mid_dvfs_cgra_tiles_across_II << endl;
-  cout << "[debug] unused_low_dvfs_cgra_tiles_across_II: " << unused_low_dvfs_cgra_tiles_across_II << endl;
+  LOG(LOG_LEVEL_DEBUG) << "[debug] unused_high_dvfs_cgra_tiles_across_II: " << unused_high_dvfs_cgra_tiles_across_II << "\n";
+  LOG(LOG_LEVEL_DEBUG) << "[debug] unused_mid_dvfs_cgra_tiles_across_II: " << unused_mid_dvfs_cgra_tiles_across_II << "\n";
+  LOG(LOG_LEVEL_DEBUG) << "[debug] unused_low_dvfs_cgra_tiles_across_II: " << unused_low_dvfs_cgra_tiles_across_II << "\n";
 
   int unlabeled_dfg_nodes = 0;
   for (auto node : nodes) {
@@ -296,7 +421,7 @@ void DFG::tuneDivPattern() {
     }
   }
   for (DFGNode* dfgNode: *removeNodes) {
-    nodes.remove(dfgNode);
+    removeNode(dfgNode);
   }
   for (DFGNode *dfgNode: *splitNodes) {
     nodes.push_back(dfgNode);
@@ -331,7 +456,7 @@ void DFG::tuneForPattern() {
       if (dfgNode->isPatternRoot()) {
         for (DFGNode* patternNode: *(dfgNode->getPatternNodes())) {
           if (hasDFGEdge(dfgNode, patternNode))
-            m_DFGEdges.remove(getDFGEdge(dfgNode, patternNode));
+            removeDFGEdge(getDFGEdge(dfgNode, patternNode));
           for (DFGNode* predNode: *(patternNode->getPredNodes())) {
             if (predNode == dfgNode or
                 predNode->isOneOfThem(dfgNode->getPatternNodes())) {
@@ -365,7 +490,7 @@ void DFG::tuneForPattern() {
     }
   }
   for (DFGNode* dfgNode: *removeNodes) {
-    nodes.remove(dfgNode);
+    removeNode(dfgNode);
   }
 }
 
@@ -691,11 +816,11 @@ list<DFGNode*>* DFG::getDFSOrderedNodes() {
       }
     }
   }
-  cout<<"\nordered nodes: \n";
+  LOG(LOG_LEVEL_DEBUG)<<"\nordered nodes: \n";
   for (DFGNode* dfgNode: *m_orderedNodes) {
-    cout<<dfgNode->getID()<<"  ";
+    LOG(LOG_LEVEL_DEBUG)<<dfgNode->getID()<<"  ";
   }
-  cout<<"\n";
+  LOG(LOG_LEVEL_DEBUG)<<"\n";
   assert(m_orderedNodes->size() == nodes.size());
   return m_orderedNodes;
 }
@@ -727,21 +852,26 @@ list<DFGNode*>* DFG::getBFSOrderedNodes() {
       }
     }
   }
-  cout<<"\nordered nodes: \n";
+  LOG(LOG_LEVEL_DEBUG)<<"\nordered nodes: \n";
   for (DFGNode* dfgNode: *m_orderedNodes) {
-    cout<<dfgNode->getID()<<"  ";
+    LOG(LOG_LEVEL_DEBUG)<<dfgNode->getID()<<"  ";
   }
-  cout<<"\n";
+  LOG(LOG_LEVEL_DEBUG)<<"\n";
   assert(m_orderedNodes->size() == nodes.size());
   return m_orderedNodes;
 }
 
  // extract DFG from specific function
  void DFG::construct(Function& t_F) {
+  ScopedTimer timer(STATS_DFG_CONSTRUCT);
 
   m_DFGEdges.clear();
   nodes.clear();
   m_ctrlEdges.clear();
+  m_valueNodes.clear();
+  m_DFGEdgeIndex.clear();
+  m_ctrlEdgeIndex.clear();
+  m_DFGEdgePositions.clear();
   m_targetBBs.clear();
 
   int nodeID = 0;
@@ -749,17 +879,17 @@ list<DFGNode*>* DFG::getBFSOrderedNodes() {
   int dfgEdgeID = 0;
   int bbID =0;
 
-  cout<<"*** current function: "<<t_F.getName().str()<<"\n";
+  LOG(LOG_LEVEL_DEBUG)<<"*** current function: "<<t_F.getName().str()<<"\n";
 
   // construct DFG Nodes.
   for (Function::iterator BB=t_F.begin(), BEnd=t_F.end(); BB!=BEnd; ++BB) {
     BasicBlock *curBB = &*BB;
     bool isTargetBB = false;
-    errs()<<"└── *** current basic block: "<<curBB->getName().str()<<"; First Inst: "<<*curBB->begin()<<"\n";
+    LOG_TO(LOG_LEVEL_DEBUG, errs())<<"└── *** current basic block: "<<curBB->getName().str()<<"; First Inst: "<<*curBB->begin()<<"\n";
     for (BasicBlock::iterator II=curBB->begin(), IEnd=curBB->end(); II!=IEnd; ++II) {
       Instruction* curII = &*II;
       if (shouldIgnore(curII)) {
-        errs()<<"│   └── *** ignored by pass because instruction \""<<*curII<<"\" is out of the scope (target loop)."<<"\n";
+        LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   └── *** ignored by pass because instruction \""<<*curII<<"\" is out of the scope (target loop).\n";
         continue;
       }
       else {
@@ -768,16 +898,17 @@ list<DFGNode*>* DFG::getBFSOrderedNodes() {
         dfgNode = new DFGNode(nodeID++, m_precisionAware, curII, getValueName(curII), m_supportDVFS);
         dfgNode->setBBID(bbID);
         nodes.push_back(dfgNode);
-        errs()<<"│   └── +++ \""<<*curII<<"\" (ID: "<<dfgNode->getID()<<")"<<"\n";
+        m_valueNodes[curII] = dfgNode;
+        LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   └── +++ \""<<*curII<<"\" (ID: "<<dfgNode->getID()<<")\n";
       }
     }
     if(isTargetBB) {
-      errs()<<"└── +++ basic block \""<<curBB->getName().str()<<"\" got ID: "<<bbID<<"\n│\n";
+      LOG_TO(LOG_LEVEL_DEBUG, errs())<<"└── +++ basic block \""<<curBB->getName().str()<<"\" got ID: "<<bbID<<"\n│\n";
       m_targetBBs.push_back(curBB);
       bbID += 1;
     }
     else{
-      errs()<<"└── *** ignored by pass because basic block \""<<curBB->getName().str()<<"\" is out of the scope (target loop)."<<"\n│\n";
+      LOG_TO(LOG_LEVEL_DEBUG, errs())<<"└── *** ignored by pass because basic block \""<<curBB->getName().str()<<"\" is out of the scope (target loop)."<<"\n│\n";
     }
   }
 
@@ -787,34 +918,34 @@ list<DFGNode*>* DFG::getBFSOrderedNodes() {
   // 2. pointed to "lonely inst"(i.e. an inst without any flow pointed to it)
   // 3. pointed to an inst without [intra-iteration & intra-basicblock] data flow pointed to it.
   for (BasicBlock* curBB : m_targetBBs) {
-    errs()<<"│\n";
-    errs()<<"└── *** curBB: "<<curBB->getName().str()<<"; First Inst: "<<*curBB->begin()<<"\n";
+    LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│\n";
+    LOG_TO(LOG_LEVEL_DEBUG, errs())<<"└── *** curBB: "<<curBB->getName().str()<<"; First Inst: "<<*curBB->begin()<<"\n";
     Instruction* terminator = curBB->getTerminator();
     if(shouldIgnore(terminator)) {
-      errs()<<"│   └── *** ignore terminator instruction \""<<*terminator<<"\""<<"\n";
+      LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   └── *** ignore terminator instruction \""<<*terminator<<"\"\n";
       continue;
     }
     else {
-      errs()<<"│   ├── *** find terminator instruction of curBB: "<<*terminator<<"\n";
+      LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   ├── *** find terminator instruction of curBB: "<<*terminator<<"\n";
       for(BasicBlock* sucBB : successors(curBB)) {
         auto it = find(m_targetBBs.begin(), m_targetBBs.end(), sucBB);
         if(it == m_targetBBs.end()) {
-          errs()<<"│   └── *** ignore sucBB \""<<sucBB->getName().str()<<"\""<<"\n";
+          LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   └── *** ignore sucBB \""<<sucBB->getName().str()<<"\"\n";
           continue;
         }
         else {
-          errs()<<"│   ├── *** into sucBB \""<<sucBB->getName().str()<<"\""<<"\n";
+          LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   ├── *** into sucBB \""<<sucBB->getName().str()<<"\"\n";
           for(BasicBlock::iterator II = sucBB->begin(), IEnd = sucBB->end(); II != IEnd; ++II) {
             Instruction* instruction = &*II;
             if(isLiveInInst(sucBB,instruction)) {
-              errs()<<"│   │   └── +++ construct ctrl flow: "<<*terminator<<"->"<<*instruction<<"\n";
+              LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   └── +++ construct ctrl flow: "<<*terminator<<"->"<<*instruction<<"\n";
               DFGEdge* ctrlEdge;
               if (hasCtrlEdge(getNode(terminator), getNode(instruction))) {
                 ctrlEdge = getCtrlEdge(getNode(terminator), getNode(instruction));
               }
               else {
                 ctrlEdge = new DFGEdge(ctrlEdgeID++, getNode(terminator), getNode(instruction), true);
-                m_ctrlEdges.push_back(ctrlEdge);
+                addCtrlEdge(ctrlEdge);
               }
             }
           }
@@ -843,7 +974,7 @@ list<DFGNode*>* DFG::getBFSOrderedNodes() {
                  (dfgEdge->getSrc()->getID()) > (dfgEdge->getDst()->getID()))) {
               dfgEdge->setInterEdge(true);
             }
-            m_DFGEdges.push_back(dfgEdge);
+            addDFGEdge(dfgEdge);
           }
       }
       else {
@@ -870,151 +1001,42 @@ list<DFGNode*>* DFG::getBFSOrderedNodes() {
 
 // Reorder the DFG nodes in ASAP based on original sequential execution order.
 void DFG::reorderInASAP() {
-
-  list<DFGNode*> tempNodes;
-  // The first node in the nodes is treated as the starting point (no
-  // matter it has predecessors or not).
-  int maxLevel = 0;
+  ScopedTimer timer(STATS_DFG_REORDER);
+  sortNodesByLevel(levelize(false));
+  LOG(LOG_LEVEL_DEBUG)<<"[reorder DFG in ASAP]\n";
   for (DFGNode* node: nodes) {
-    int level = 0;
-    for (DFGNode* predNode: *(node->getPredNodes())) {
-      if (predNode->getID() < node->getID()) {
-        if (level < predNode->getLevel() + 1) {
-          level = predNode->getLevel() + 1;
-        }
-      }
-    }
-    node->setLevel(level);
-    if (maxLevel < level) {
-      maxLevel = level;
-    }
-  }
-
-  for (int l=0; l<maxLevel+1; ++l) {
-    for (DFGNode* node: nodes) {
-      if (node->getLevel() == l) {
-        tempNodes.push_back(node);
-      }
-    }
-  }
-
-  nodes.clear();
-  cout<<"[reorder DFG in ASAP]\n";
-  for (DFGNode* node: tempNodes) {
-    nodes.push_back(node);
-    errs()<<"("<<node->getID()<<") "<<*(node->getInst())<<", level: "<<node->getLevel()<<"\n";
+    LOG_TO(LOG_LEVEL_DEBUG, errs())<<"("<<node->getID()<<") "<<*(node->getInst())<<", level: "<<node->getLevel()<<"\n";
   }
 }
 
-bool DFG::isMinimumAndHasNotBeenVisited(set<DFGNode*>* t_visited, map<DFGNode*, int>* t_map, DFGNode* t_node) {
-  if (t_visited->find(t_node) != t_visited->end()) {
-    return false;
-  }
-  for (DFGNode* e_node: nodes) {
-    if (e_node != t_node and t_visited->find(e_node) == t_visited->end() and (*t_map)[e_node] < (*t_map)[t_node]) {
-      return false;
-    }
-  }
-  return true;
-}
-
-// Reorder the DFG nodes based on the longest path.
+// Reorder the DFG nodes based on the longest path. Without the edges
+// towards the earlier nodes (see levelize()), the DFG is a DAG, on which
+// the longest path reaching each node is its ASAP level.
 void DFG::reorderInLongest() {
-  list<DFGNode*>* longestPath = new list<DFGNode*>();
-  list<DFGNode*>* currentPath = new list<DFGNode*>();
-  set<DFGNode*>* visited = new set<DFGNode*>();
-  map<DFGNode*, int> indegree;
+  ScopedTimer timer(STATS_DFG_REORDER);
+  sortNodesByLevel(levelize(false));
+  LOG(LOG_LEVEL_DEBUG)<<"[reorder DFG along with the longest path]\n";
   for (DFGNode* node: nodes) {
-    indegree[node] = node->getPredNodes()->size();
-    currentPath->clear();
-    visited->clear();
-    reorderDFS(visited, longestPath, currentPath, node);
-  }
-
-  visited->clear();
-  int level = 0;
-  for (DFGNode* node: *longestPath) {
-    node->setLevel(level);
-    visited->insert(node);
-    //cout<<"check longest path node: "<<node->getID()<<endl;
-    for (DFGNode* succNode: *(node->getSuccNodes())) {
-      indegree[succNode] -= 1;
-    }
-    level += 1;
-  }
-  int maxLevel = level;
-
-  while (visited->size() < nodes.size()) {
-    for (DFGNode* node: nodes) {
-      // if (visited->find(node) == visited->end() and indegree[node] <= 0) {
-      if (isMinimumAndHasNotBeenVisited(visited, &indegree, node)) {
-        level = 0;
-        for (DFGNode* preNode: *(node->getPredNodes())) {
-          if (level < preNode->getLevel() + 1) {
-            level = preNode->getLevel() + 1;
-          }
-        }
-        node->setLevel(level);
-        visited->insert(node);
-        for (DFGNode* succNode: *(node->getSuccNodes())) {
-          indegree[succNode] -= 1;
-        }
-      }
-    }
-  }
-
-  list<DFGNode*> tempNodes;
-  for (int l=0; l<maxLevel+1; ++l) {
-    for (DFGNode* node: nodes) {
-      if (node->getLevel() == l) {
-        tempNodes.push_back(node);
-      }
-    }
-  }
-
-  nodes.clear();
-  cout<<"[reorder DFG along with the longest path]\n";
-  for (DFGNode* node: tempNodes) {
-    nodes.push_back(node);
-    errs()<<"("<<node->getID()<<") "<<*(node->getInst())<<", level: "<<node->getLevel()<<"\n";
-  }
-
-}
-
-void DFG::reorderDFS(set<DFGNode*>* t_visited, list<DFGNode*>* t_targetPath,
-                     list<DFGNode*>* t_curPath, DFGNode* targetDFGNode) {
-
-  t_visited->insert(targetDFGNode);
-  t_curPath->push_back(targetDFGNode);
-
-  // Update target longest path if current one is longer.
-  if (t_curPath->size() > t_targetPath->size()) {
-    t_targetPath->clear();
-    for (DFGNode* node: *t_curPath) {
-      t_targetPath->push_back(node);
-    }
+    LOG_TO(LOG_LEVEL_DEBUG, errs())<<"("<<node->getID()<<") "<<*(node->getInst())<<", level: "<<node->getLevel()<<"\n";
   }
-
-  for (DFGNode* succNode: *(targetDFGNode->getSuccNodes())) {
-    if (t_visited->find(succNode) == t_visited->end()) { // not visited yet
-      reorderDFS(t_visited, t_targetPath, t_curPath, succNode);
-      t_visited->erase(succNode);
-      t_curPath->pop_back();
-    }
-  }
-
 }
 
 void DFG::reorderInCriticalFirst() {
   // Step 1: Uses longest path ordering to initialize levels.
   reorderInLongest();
+  ScopedTimer timer(STATS_DFG_REORDER);
 
   // Step 2: Separates critical and non-critical nodes.
   std::list<DFGNode*> criticalNodes;
   std::list<DFGNode*> nonCriticalNodes;
+  std::set<DFGNode*> cycleNodes;
+  for (list<DFGNode*>* cycle: *m_cycleNodeLists) {
+    if (cycle)
+      cycleNodes.insert(cycle->begin(), cycle->end());
+  }
 
   for (DFGNode* node : nodes) {
-    if (isNodeOnCriticalPath(node)) {
+    if (cycleNodes.count(node)) {
       criticalNodes.push_back(node);
     } else {
       nonCriticalNodes.push_back(node);
@@ -1025,14 +1047,14 @@ void DFG::reorderInCriticalFirst() {
   nodes.clear();
   for (DFGNode* node : criticalNodes) {
     nodes.push_back(node);
-    errs() << "[CRITICAL] (" << node->getID() << ") " << *(node->getInst()) << "\n";
+    LOG_TO(LOG_LEVEL_DEBUG, errs()) << "[CRITICAL] (" << node->getID() << ") " << *(node->getInst()) << "\n";
   }
   for (DFGNode* node : nonCriticalNodes) {
     nodes.push_back(node);
-    errs() << "[NON-CRITICAL] (" << node->getID() << ") " << *(node->getInst()) << "\n";
+    LOG_TO(LOG_LEVEL_DEBUG, errs()) << "[NON-CRITICAL] (" << node->getID() << ") " << *(node->getInst()) << "\n";
   }
 
-  std::cout << "[reorder DFG with critical path nodes first]\n";
+  LOG(LOG_LEVEL_DEBUG) << "[reorder DFG with critical path nodes first]\n";
 }
 
 bool DFG::isNodeOnCriticalPath(DFGNode* t_node) {
@@ -1052,19 +1074,38 @@ bool DFG::isNodeOnCriticalPath(DFGNode* t_node) {
 
 // Reorder the DFG nodes in ALAP based on original sequential execution order.
 void DFG::reorderInALAP() {
+  ScopedTimer timer(STATS_DFG_REORDER);
+  sortNodesByLevel(levelize(true));
+  LOG(LOG_LEVEL_DEBUG)<<"[reorder DFG in ALAP]\n";
+  for (DFGNode* node: nodes) {
+    LOG_TO(LOG_LEVEL_DEBUG, errs())<<"("<<node->getID()<<") "<<*(node->getInst())<<", level: "<<node->getLevel()<<"\n";
+  }
+}
 
-  list<DFGNode*> tempNodes;
-  // The last node in the nodes is treated as the end point (no
-  // matter it has successors or not).
+// Levelizes the nodes in O(V+E) in one pass over the original sequential
+// execution order (i.e., the order of the nodes). Only the edges from a
+// node to a later one (i.e., with a larger ID) are followed, which cuts
+// the loop-carried edges (see the inter edges in construct()) and leaves a
+// DAG. The level of a node is the longest path reaching it, or, for ALAP,
+// the maximum level minus the longest path leaving it. Returns the maximum
+// level.
+int DFG::levelize(bool t_ALAP) {
+  // The first (or, for ALAP, the last) node in the nodes is treated as the
+  // starting point (no matter it has predecessors or not).
+  list<DFGNode*> orderedNodes(nodes);
+  if (t_ALAP) {
+    orderedNodes.reverse();
+  }
   int maxLevel = 0;
-  nodes.reverse();
-  for (DFGNode* node: nodes) {
+  for (DFGNode* node: orderedNodes) {
     int level = 0;
-    for (DFGNode* succNode: *(node->getSuccNodes())) {
-      if (succNode->getID() > node->getID()) {
-        if (level < succNode->getLevel() + 1) {
-          level = succNode->getLevel() + 1;
-        }
+    list<DFGNode*>* nextNodes = t_ALAP ? node->getSuccNodes() :
+                                         node->getPredNodes();
+    for (DFGNode* nextNode: *nextNodes) {
+      bool isFollowed = t_ALAP ? nextNode->getID() > node->getID() :
+                                 nextNode->getID() < node->getID();
+      if (isFollowed and level < nextNode->getLevel() + 1) {
+        level = nextNode->getLevel() + 1;
       }
     }
     node->setLevel(level);
@@ -1072,24 +1113,26 @@ void DFG::reorderInALAP() {
       maxLevel = level;
     }
   }
-
-  for (DFGNode* node: nodes) {
-    node->setLevel(maxLevel - node->getLevel());
+  if (t_ALAP) {
+    for (DFGNode* node: orderedNodes) {
+      node->setLevel(maxLevel - node->getLevel());
+    }
   }
+  return maxLevel;
+}
 
-  for (int l=0; l<maxLevel+1; ++l) {
-    for (DFGNode* node: nodes) {
-      if (node->getLevel() == l) {
-        tempNodes.push_back(node);
-      }
+// Stably sorts the nodes by their levels in O(V + levels), where the nodes
+// beyond the maximum level are dropped as before.
+void DFG::sortNodesByLevel(int t_maxLevel) {
+  vector<list<DFGNode*>> buckets(t_maxLevel + 1);
+  for (DFGNode* node: nodes) {
+    if (node->getLevel() >= 0 and node->getLevel() <= t_maxLevel) {
+      buckets[node->getLevel()].push_back(node);
     }
   }
-
   nodes.clear();
-  cout<<"[reorder DFG in ALAP]\n";
-  for (DFGNode* node: tempNodes) {
-    nodes.push_back(node);
-    errs()<<"("<<node->getID()<<") "<<*(node->getInst())<<", level: "<<node->getLevel()<<"\n";
+  for (list<DFGNode*>& bucket: buckets) {
+    nodes.splice(nodes.end(), bucket);
   }
 }
 
@@ -1107,11 +1150,11 @@ void DFG::initExecLatency(map<string, int>* t_execLatency) {
     }
   }
   if (!targetOpt.empty()) {
-    cout<<"\033[0;31mPlease check the operations targeting multi-cycle execution in <param.json>:\"\033[0m";
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31mPlease check the operations targeting multi-cycle execution in <param.json>:\"\033[0m";
     for (set<string>::iterator it = targetOpt.begin(); it != targetOpt.end(); ++it) {
-      cout<<" "<<*it<<" "; // Note the "*" here
+      LOG(LOG_LEVEL_ERROR)<<" "<<*it<<" "; // Note the "*" here
     }
-    cout<<"\033[0;31m\".\033[0m"<<endl;
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31m\".\033[0m"<<endl;
   }
 }
 
@@ -1130,11 +1173,11 @@ void DFG::initPipelinedOpt(list<string>* t_pipelinedOpt) {
     }
   }
   if (!targetOpt.empty()) {
-    cout<<"\033[0;31mPlease check the pipelinable operations in <param.json>:\"\033[0m";
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31mPlease check the pipelinable operations in <param.json>:\"\033[0m";
     for (set<string>::iterator it = targetOpt.begin(); it != targetOpt.end(); ++it) {
-      cout<<" "<<*it<<" "; // Note the "*" here
+      LOG(LOG_LEVEL_ERROR)<<" "<<*it<<" "; // Note the "*" here
     }
-    cout<<"\033[0;31m\".\033[0m"<<endl;
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31m\".\033[0m"<<endl;
   }
 }
 
@@ -1164,8 +1207,8 @@ void DFG::initPipelinedOpt(list<string>* t_pipelinedOpt) {
 
    // type 1
    if(t_inst == &(t_bb->front())) {
-     errs()<<"│   │   ├── Type: first inst of a BB."<<"\n";
-     errs()<<"│   │   ├── ctrl flow point to: "<<*t_inst<<"; In BB: "<<t_bb->getName().str()<<"\n";
+     LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   ├── Type: first inst of a BB.\n";
+     LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   ├── ctrl flow point to: "<<*t_inst<<"; In BB: "<<t_bb->getName().str()<<"\n";
      return true;
    }
 
@@ -1182,13 +1225,13 @@ void DFG::initPipelinedOpt(list<string>* t_pipelinedOpt) {
      }
    }
    if(isLonelyInst) {
-     errs()<<"│   │   ├── Type: lonely inst."<<"\n";
-     errs()<<"│   │   ├── ctrl flow point to: "<<*t_inst<<"; In BB: "<<t_bb->getName().str()<<"\n";
+     LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   ├── Type: lonely inst.\n";
+     LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   ├── ctrl flow point to: "<<*t_inst<<"; In BB: "<<t_bb->getName().str()<<"\n";
      return true;
    }
    else if(!isUsingIntraIterationData) {
-     errs()<<"│   │   ├── Type: inst without [intra-basicblock & intra-iteration data flow] nor [ctrl flow] pointed to it."<<"\n";
-     errs()<<"│   │   ├── ctrl flow point to: "<<*t_inst<<"; In BB: "<<t_bb->getName().str()<<"\n";
+     LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   ├── Type: inst without [intra-basicblock & intra-iteration data flow] nor [ctrl flow] pointed to it.\n";
+     LOG_TO(LOG_LEVEL_DEBUG, errs())<<"│   │   ├── ctrl flow point to: "<<*t_inst<<"; In BB: "<<t_bb->getName().str()<<"\n";
      return true;
    }
 
@@ -1230,7 +1273,7 @@ void DFG::connectDFGNodes() {
   // Incorporate ctrl flow into data flow.
   if (!m_CDFGFused) {
     for (DFGEdge* edge: m_ctrlEdges) {
-      m_DFGEdges.push_back(edge);
+      addDFGEdge(edge);
     }
     m_CDFGFused = true;
   }
@@ -1252,9 +1295,56 @@ void DFG::connectDFGNodes() {
 
 }
 
+// Writes the indices of the given nodes (see generateJSON()), where -1
+// stands for a node that is no longer in the DFG.
+static void writeJSONIndices(ostream& t_jsonFile, list<DFGNode*>* t_nodes,
+                             map<DFGNode*, int>& t_nodeIndices) {
+  t_jsonFile<<"[";
+  if (t_nodes != NULL) {
+    int index = 0;
+    for (DFGNode* node: *t_nodes) {
+      if (index++ > 0)
+        t_jsonFile<<",";
+      auto it = t_nodeIndices.find(node);
+      t_jsonFile<<(it == t_nodeIndices.end() ? -1 : it->second);
+    }
+  }
+  t_jsonFile<<"]";
+}
+
+// Besides the names and the IDs of the nodes, each entry keeps what the
+// mapping depends on, so that the DFG read back from dfg.json (see
+// DFG(string, ...)) is mapped the same as this one. The nodes split by the
+// distributed strategy share their IDs, so the nodes are referred by their
+// indices in the file instead (i.e., "*_index", "predicatees", "cycles" and
+// "out_edges"). The nodes fused into a pattern are no longer in the DFG but
+// still listed by their neighbors, which is kept as -1.
 void DFG::generateJSON() {
-  ofstream jsonFile;
-  jsonFile.open("dfg.json");
+  ScopedTimer timer(STATS_WRITE_JSON);
+  map<DFGNode*, int> nodeIndices;
+  for (DFGNode* node: nodes) {
+    nodeIndices.insert(make_pair(node, nodeIndices.size()));
+  }
+  map<DFGNode*, list<DFGEdge*>> outEdges;
+  for (DFGEdge* edge: m_DFGEdges) {
+    outEdges[edge->getSrc()].push_back(edge);
+  }
+  // The position of each node on each cycle (along with the length of the
+  // cycle), as a cycle is walked in its order by the mapper.
+  map<DFGNode*, list<vector<int>>> cyclePositions;
+  int cycleIndex = 0;
+  for (list<DFGNode*>* cycle: *m_cycleNodeLists) {
+    int position = 0;
+    for (DFGNode* node: *cycle) {
+      cyclePositions[node].push_back({cycleIndex, position++,
+                                      (int)cycle->size()});
+    }
+    cycleIndex += 1;
+  }
+
+  // The whole file is assembled in memory and written out at once.
+  ostringstream jsonFile;
+  jsonFile<<boolalpha;
   jsonFile<<"[\n";
   int node_index = 0;
   int node_size = nodes.size();
@@ -1291,7 +1381,53 @@ void DFG::generateJSON() {
       if (out_index < out_size)
         jsonFile<<",";
     }
-    jsonFile<<"]]\n";
+    jsonFile<<"]],\n";
+    jsonFile<<"    \"opcode\"      : \""<<node->getRawOpcodeName()<<"\",\n";
+    jsonFile<<"    \"vectorized\"  : "<<node->isVectorized()<<",\n";
+    jsonFile<<"    \"phi\"         : "<<node->isPhiInst()<<",\n";
+    jsonFile<<"    \"call\"        : \""<<node->getCalledFunction()<<"\",\n";
+    jsonFile<<"    \"fused\"       : "<<node->hasCombined()<<",\n";
+    jsonFile<<"    \"fused_type\"  : \""<<node->getComplexType()<<"\",\n";
+    jsonFile<<"    \"latency\"     : "<<node->getRawExecLatency()<<",\n";
+    jsonFile<<"    \"pipelinable\" : "<<node->isPipelinable()<<",\n";
+    jsonFile<<"    \"critical\"    : "<<node->isCritical()<<",\n";
+    jsonFile<<"    \"cycle_ids\"   : [";
+    int cycle_id_index = 0;
+    for (int cycleID: *(node->getCycleIDs())) {
+      if (cycle_id_index++ > 0)
+        jsonFile<<",";
+      jsonFile<<cycleID;
+    }
+    jsonFile<<"],\n";
+    jsonFile<<"    \"cycles\"      : [";
+    int cycle_index = 0;
+    for (vector<int>& cyclePosition: cyclePositions[node]) {
+      if (cycle_index++ > 0)
+        jsonFile<<",";
+      jsonFile<<"["<<cyclePosition[0]<<","<<cyclePosition[1]<<","
+              <<cyclePosition[2]<<"]";
+    }
+    jsonFile<<"],\n";
+    jsonFile<<"    \"predicatee\"  : "<<node->isPredicatee()<<",\n";
+    jsonFile<<"    \"predicatees\" : ";
+    writeJSONIndices(jsonFile, node->getPredicatees(), nodeIndices);
+    jsonFile<<",\n";
+    jsonFile<<"    \"pre_index\"   : ";
+    writeJSONIndices(jsonFile, node->getPredNodes(), nodeIndices);
+    jsonFile<<",\n";
+    jsonFile<<"    \"succ_index\"  : ";
+    writeJSONIndices(jsonFile, node->getSuccNodes(), nodeIndices);
+    jsonFile<<",\n";
+    jsonFile<<"    \"out_edges\"   : [";
+    int edge_index = 0;
+    for (DFGEdge* edge: outEdges[node]) {
+      if (nodeIndices.find(edge->getDst()) == nodeIndices.end())
+        continue;
+      if (edge_index++ > 0)
+        jsonFile<<",";
+      jsonFile<<"["<<nodeIndices[edge->getDst()]<<","<<edge->isCtrlEdge()<<"]";
+    }
+    jsonFile<<"]\n";
     node_index += 1;
     if (node_index < node_size)
       jsonFile<<"  },\n";
@@ -1299,10 +1435,12 @@ void DFG::generateJSON() {
       jsonFile<<"  }\n";
   }
   jsonFile<<"]\n";
-  jsonFile.close();
+  ofstream dfgFile("dfg.json");
+  dfgFile<<jsonFile.str();
 }
 
 void DFG::generateDot(Function &t_F, bool t_isTrimmedDemo) {
+  ScopedTimer timer(STATS_WRITE_DOT);
 
   error_code error;
 //  sys::fs::OpenFlags F_Excl;
@@ -1383,62 +1521,145 @@ void DFG::generateDot(Function &t_F, bool t_isTrimmedDemo) {
 
 }
 
-void DFG::DFS_on_DFG(DFGNode* t_head, DFGNode* t_current,
-    list<DFGNode*>* t_visitedNodes, list<DFGEdge*>* t_erasedEdges,
-    list<DFGEdge*>* t_currentCycle, list<list<DFGEdge*>*>* t_cycles) {
-  for (DFGEdge* edge: m_DFGEdges) {
-    if (find(t_erasedEdges->begin(), t_erasedEdges->end(), edge) != t_erasedEdges->end())
+// Searches the cycles through the head node in depth-first order, where
+// each node is visited at most once per head and the edge closing a cycle
+// is erased to avoid detecting the cycle again from another head. The
+// search never leaves the strongly connected component of the head, as no
+// cycle through the head can.
+void DFG::DFS_on_DFG(int t_head, int t_current, CycleSearch* t_search,
+    list<list<DFGEdge*>*>* t_cycles) {
+  for (int edgeIndex: t_search->outEdges[t_current]) {
+    if (t_search->erasedEdges[edgeIndex])
       continue;
-    // check whether the IR is equal
-    if (edge->getSrc() == t_current) {
-      // skip the visited nodes/edges:
-      if (find(t_currentCycle->begin(), t_currentCycle->end(), edge) != t_currentCycle->end()) {
-        continue;
+    int dst = t_search->edgeDsts[edgeIndex];
+    if (t_search->components[dst] != t_search->components[t_head])
+      continue;
+    // skip the visited nodes/edges:
+    if (t_search->onCurrentCycle[edgeIndex])
+      continue;
+    t_search->currentCycle.push_back(edgeIndex);
+    t_search->onCurrentCycle[edgeIndex] = true;
+
+    if (dst == t_head) {
+      DFGNode* head = t_search->edges[edgeIndex]->getDst();
+      LOG(LOG_LEVEL_TRACE) << "==================================\n";
+      LOG_TO(LOG_LEVEL_TRACE, errs()) << "[detected one cycle] head: "<<describeNode(head)<<"\n";
+      list<DFGEdge*>* temp_cycle = new list<DFGEdge*>();
+      for (int currentEdgeIndex: t_search->currentCycle) {
+        DFGEdge* currentEdge = t_search->edges[currentEdgeIndex];
+        temp_cycle->push_back(currentEdge);
+        // break the cycle to avoid future repeated detection
+        LOG_TO(LOG_LEVEL_TRACE, errs()) << "cycle edge: {" << describeNode(currentEdge->getSrc()) << "  } -> {"<< describeNode(currentEdge->getDst()) << "  } ("<<currentEdge->getSrc()->getID()<<" -> "<<currentEdge->getDst()->getID()<<")\n";
       }
-      t_currentCycle->push_back(edge);
-
-//      cout << ".. add current cycle edge: {" << *edge->getSrc()->getInst() << "  } -> {"<< *edge->getDst()->getInst() << "  } ("<<edge->getSrc()->getID()<<" -> "<<edge->getDst()->getID()<<")\n";
-      if (edge->getDst() == t_head) {
-        cout << "==================================\n";
-        errs() << "[detected one cycle] head: "<<*(t_head->getInst())<<"\n";
-        list<DFGEdge*>* temp_cycle = new list<DFGEdge*>();
-        for (DFGEdge* currentEdge: *t_currentCycle) {
-          temp_cycle->push_back(currentEdge);
-          // break the cycle to avoid future repeated detection
-          errs() << "cycle edge: {" << *((currentEdge)->getSrc()->getInst()) << "  } -> {"<< *((currentEdge)->getDst()->getInst()) << "  } ("<<currentEdge->getSrc()->getID()<<" -> "<<currentEdge->getDst()->getID()<<")\n";
-        }
-        t_erasedEdges->push_back(edge);
-        t_cycles->push_back(temp_cycle);
-        t_currentCycle->remove(edge);
-      } else {
-        if (find(t_visitedNodes->begin(), t_visitedNodes->end(), edge->getDst()) == t_visitedNodes->end()) {
-          t_visitedNodes->push_back(edge->getDst());
-          // Only continue when the path size is less than the node count.
-          if (t_currentCycle->size() <= nodes.size()) {
-            DFS_on_DFG(t_head, edge->getDst(), t_visitedNodes, t_erasedEdges, t_currentCycle, t_cycles);
-          }
-        } else {
-          t_currentCycle->remove(edge);
-        }
+      t_search->erasedEdges[edgeIndex] = true;
+      t_cycles->push_back(temp_cycle);
+      t_search->currentCycle.pop_back();
+      t_search->onCurrentCycle[edgeIndex] = false;
+    } else if (!t_search->visitedNodes[dst]) {
+      t_search->visitedNodes[dst] = true;
+      // Only continue when the path size is less than the node count.
+      if (t_search->currentCycle.size() <= nodes.size()) {
+        DFS_on_DFG(t_head, dst, t_search, t_cycles);
       }
+    } else {
+      t_search->currentCycle.pop_back();
+      t_search->onCurrentCycle[edgeIndex] = false;
     }
   }
-  if (t_currentCycle->size()!=0) {
-    t_currentCycle->pop_back();
+  if (t_search->currentCycle.size() != 0) {
+    t_search->onCurrentCycle[t_search->currentCycle.back()] = false;
+    t_search->currentCycle.pop_back();
+  }
+}
+
+// Tarjan's algorithm (with an explicit stack) that assigns each node the
+// ID of its strongly connected component.
+void DFG::calculateComponents(CycleSearch* t_search) {
+  int nodeCount = t_search->outEdges.size();
+  vector<int> indices(nodeCount, -1);
+  vector<int> lowLinks(nodeCount, 0);
+  vector<bool> onStack(nodeCount, false);
+  vector<int> stack;
+  // The nodes being visited along with the position of their next out edge.
+  vector<pair<int, int>> frames;
+  int index = 0;
+  int componentID = 0;
+  t_search->components.assign(nodeCount, -1);
+  for (int root=0; root<nodeCount; ++root) {
+    if (indices[root] != -1)
+      continue;
+    frames.push_back(make_pair(root, 0));
+    while (!frames.empty()) {
+      int node = frames.back().first;
+      int next = frames.back().second;
+      if (next == 0 and indices[node] == -1) {
+        indices[node] = lowLinks[node] = index++;
+        stack.push_back(node);
+        onStack[node] = true;
+      }
+      if (next < t_search->outEdges[node].size()) {
+        ++frames.back().second;
+        int dst = t_search->edgeDsts[t_search->outEdges[node][next]];
+        if (indices[dst] == -1) {
+          frames.push_back(make_pair(dst, 0));
+        } else if (onStack[dst]) {
+          lowLinks[node] = min(lowLinks[node], indices[dst]);
+        }
+        continue;
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        int parent = frames.back().first;
+        lowLinks[parent] = min(lowLinks[parent], lowLinks[node]);
+      }
+      if (lowLinks[node] == indices[node]) {
+        int member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          onStack[member] = false;
+          t_search->components[member] = componentID;
+        } while (member != node);
+        ++componentID;
+      }
+    }
   }
 }
 
 list<list<DFGEdge*>*>* DFG::calculateCycles() {
+  ScopedTimer timer(STATS_DFG_CYCLES);
   list<list<DFGEdge*>*>* cycleLists = new list<list<DFGEdge*>*>();
-  list<DFGEdge*>* currentCycle = new list<DFGEdge*>();
-  list<DFGNode*>* visitedNodes = new list<DFGNode*>();
-  list<DFGEdge*>* erasedEdges = new list<DFGEdge*>();
-  cycleLists->clear();
+
+  // Indexes the nodes, including the ones only referred by the edges.
+  map<DFGNode*, int> nodeIndices;
   for (DFGNode* node: nodes) {
-    currentCycle->clear();
-    visitedNodes->clear();
-    visitedNodes->push_back(node);
-    DFS_on_DFG(node, node, visitedNodes, erasedEdges, currentCycle, cycleLists);
+    nodeIndices.insert(make_pair(node, nodeIndices.size()));
+  }
+  for (DFGEdge* edge: m_DFGEdges) {
+    nodeIndices.insert(make_pair(edge->getSrc(), nodeIndices.size()));
+    nodeIndices.insert(make_pair(edge->getDst(), nodeIndices.size()));
+  }
+  CycleSearch search;
+  search.outEdges.resize(nodeIndices.size());
+  for (DFGEdge* edge: m_DFGEdges) {
+    search.outEdges[nodeIndices[edge->getSrc()]].push_back(search.edges.size());
+    search.edges.push_back(edge);
+    search.edgeDsts.push_back(nodeIndices[edge->getDst()]);
+  }
+  calculateComponents(&search);
+  search.visitedNodes.assign(nodeIndices.size(), false);
+  search.erasedEdges.assign(search.edges.size(), false);
+  search.onCurrentCycle.assign(search.edges.size(), false);
+
+  for (DFGNode* node: nodes) {
+    int head = nodeIndices[node];
+    for (int edgeIndex: search.currentCycle) {
+      search.onCurrentCycle[edgeIndex] = false;
+    }
+    search.currentCycle.clear();
+    search.visitedNodes.assign(nodeIndices.size(), false);
+    search.visitedNodes[head] = true;
+    DFS_on_DFG(head, head, &search, cycleLists);
   }
   int cycleID = 0;
   m_cycleNodeLists->clear();
@@ -1467,7 +1688,7 @@ void DFG::showOpcodeDistribution() {
   }
   for (map<string, int>::iterator opcodeItr=opcodeMap.begin();
       opcodeItr!=opcodeMap.end(); ++opcodeItr) {
-    cout << (*opcodeItr).first << " : " << (*opcodeItr).second << "\n";
+    LOG(LOG_LEVEL_INFO) << (*opcodeItr).first << " : " << (*opcodeItr).second << "\n";
   }
   int simdNodeCount = 0;
   for (DFGNode* node: nodes) {
@@ -1475,7 +1696,7 @@ void DFG::showOpcodeDistribution() {
       simdNodeCount++;
     }
   }
-  cout << "DFG node count: "<<nodes.size()<<"; DFG edge count: "<<m_DFGEdges.size()<<"; SIMD node count: "<<simdNodeCount<<"\n";
+  LOG(LOG_LEVEL_INFO) << "DFG node count: "<<nodes.size()<<"; DFG edge count: "<<m_DFGEdges.size()<<"; SIMD node count: "<<simdNodeCount<<"\n";
 }
 
 int DFG::getID(DFGNode* t_node) {
@@ -1484,101 +1705,109 @@ int DFG::getID(DFGNode* t_node) {
 }
 
 DFGNode* DFG::getNode(Value* t_value) {
-  for (DFGNode* node: nodes) {
-    if (node->getInst() == t_value) {
-      return node;
-    }
+  unordered_map<Value*, DFGNode*>::iterator it = m_valueNodes.find(t_value);
+  if (it != m_valueNodes.end()) {
+    return it->second;
   }
   assert("ERROR cannot find the corresponding DFG node.");
   return NULL;
 }
 
 bool DFG::hasNode(Value* t_value) {
-  for (DFGNode* node: nodes) {
-    if (node->getInst() == t_value) {
-      return true;
-    }
+  return m_valueNodes.find(t_value) != m_valueNodes.end();
+}
+
+void DFG::removeNode(DFGNode* t_node) {
+  nodes.remove(t_node);
+  unordered_map<Value*, DFGNode*>::iterator it =
+      m_valueNodes.find(t_node->getInst());
+  if (it != m_valueNodes.end() and it->second == t_node) {
+    m_valueNodes.erase(it);
   }
-  return false;
 }
 
 DFGEdge* DFG::getCtrlEdge(DFGNode* t_src, DFGNode* t_dst) {
-  for (DFGEdge* edge: m_ctrlEdges) {
-    if (edge->getSrc() == t_src and
-        edge->getDst() == t_dst) {
-      return edge;
-    }
+  auto it = m_ctrlEdgeIndex.find(make_pair(t_src, t_dst));
+  if (it != m_ctrlEdgeIndex.end()) {
+    return it->second.front();
   }
   assert("ERROR cannot find the corresponding Ctrl edge.");
   return NULL;
 }
 
 bool DFG::hasCtrlEdge(DFGNode* t_src, DFGNode* t_dst) {
-  for (DFGEdge* edge: m_ctrlEdges) {
-    if (edge->getSrc() == t_src and
-        edge->getDst() == t_dst) {
-      return true;
-    }
-  }
-  return false;
+  return m_ctrlEdgeIndex.find(make_pair(t_src, t_dst)) != m_ctrlEdgeIndex.end();
 }
 
 DFGEdge* DFG::getDFGEdge(DFGNode* t_src, DFGNode* t_dst) {
-  for (DFGEdge* edge: m_DFGEdges) {
-    if (edge->getSrc() == t_src and
-        edge->getDst() == t_dst) {
-      return edge;
-    }
-
+  auto it = m_DFGEdgeIndex.find(make_pair(t_src, t_dst));
+  if (it != m_DFGEdgeIndex.end()) {
+    return it->second.front();
   }
   assert("ERROR cannot find the corresponding DFG edge.");
   return NULL;
 }
 
+void DFG::addDFGEdge(DFGEdge* t_edge) {
+  m_DFGEdges.push_back(t_edge);
+  m_DFGEdgePositions[t_edge] = prev(m_DFGEdges.end());
+  m_DFGEdgeIndex[make_pair(t_edge->getSrc(), t_edge->getDst())].push_back(t_edge);
+}
+
+void DFG::removeDFGEdge(DFGEdge* t_edge) {
+  auto position = m_DFGEdgePositions.find(t_edge);
+  if (position == m_DFGEdgePositions.end())
+    return;
+  m_DFGEdges.erase(position->second);
+  m_DFGEdgePositions.erase(position);
+  auto it = m_DFGEdgeIndex.find(make_pair(t_edge->getSrc(), t_edge->getDst()));
+  it->second.remove(t_edge);
+  if (it->second.empty()) {
+    m_DFGEdgeIndex.erase(it);
+  }
+}
+
+void DFG::addCtrlEdge(DFGEdge* t_edge) {
+  m_ctrlEdges.push_back(t_edge);
+  m_ctrlEdgeIndex[make_pair(t_edge->getSrc(), t_edge->getDst())].push_back(t_edge);
+}
+
 void DFG::replaceDFGEdge(DFGNode* t_old_src, DFGNode* t_old_dst,
                          DFGNode* t_new_src, DFGNode* t_new_dst) {
   DFGEdge* target = NULL;
-  cout<<"replace edge: [delete] "<<t_old_src->getID()<<"->"<<t_old_dst->getID()<<" [new] "<<t_new_src->getID()<<"->"<<t_new_dst->getID()<<"\n";
-  for (DFGEdge* edge: m_DFGEdges) {
-    if (edge->getSrc() == t_old_src and
-        edge->getDst() == t_old_dst) {
-      target = edge;
-      break;
-    }
+  LOG(LOG_LEVEL_DEBUG)<<"replace edge: [delete] "<<t_old_src->getID()<<"->"<<t_old_dst->getID()<<" [new] "<<t_new_src->getID()<<"->"<<t_new_dst->getID()<<"\n";
+  if (hasDFGEdge(t_old_src, t_old_dst)) {
+    target = getDFGEdge(t_old_src, t_old_dst);
   }
   if (target == NULL) {
     assert("ERROR cannot find the corresponding DFG edge.");
-    cout << "ERROR cannot find the corresponding DFG edge\n";
+    LOG(LOG_LEVEL_ERROR) << "ERROR cannot find the corresponding DFG edge\n";
     return;
   }
-  m_DFGEdges.remove(target);
+  removeDFGEdge(target);
   // Keeps the ctrl property of the original edge on the newly added edge.
   DFGEdge* newEdge = new DFGEdge(target->getID(), t_new_src, t_new_dst, target->isCtrlEdge());
-  m_DFGEdges.push_back(newEdge);
+  addDFGEdge(newEdge);
   if (newEdge->isCtrlEdge()){
-    m_ctrlEdges.push_back(newEdge);
+    addCtrlEdge(newEdge);
   }
 }
 
 // used for the case of tuning division patterns
 void DFG::replaceMultipleDFGEdge(DFGNode* t_old_src, DFGNode* t_old_dst,
                          DFGNode** t_new_src, DFGNode** t_new_dst) {
-  cout << "replace multiple dfg edges" << "\n";
+  LOG(LOG_LEVEL_DEBUG) << "replace multiple dfg edges\n";
   DFGEdge* target = NULL;
-  cout<<"replace edge: [delete] "<<t_old_src->getID()<<"->"<<t_old_dst->getID()<<"\n";
-  for (DFGEdge* edge: m_DFGEdges) {
-    if (edge->getSrc() == t_old_src and
-        edge->getDst() == t_old_dst) {
-      target = edge;
-      break;
-    }
+  LOG(LOG_LEVEL_DEBUG)<<"replace edge: [delete] "<<t_old_src->getID()<<"->"<<t_old_dst->getID()<<"\n";
+  if (hasDFGEdge(t_old_src, t_old_dst)) {
+    target = getDFGEdge(t_old_src, t_old_dst);
   }
   if (target == NULL) {
-    cout << "ERROR cannot find the corresponding DFG edge\n";
+    LOG(LOG_LEVEL_ERROR) << "ERROR cannot find the corresponding DFG edge\n";
     return;
   }
   int dfgEdgeID = m_DFGEdges.size();
-  m_DFGEdges.remove(target);
+  removeDFGEdge(target);
   // Keeps the ctrl property of the original edge on the newly added edge.
   for (int i = 0; i < m_vectorFactorForIdiv; i++) {
     DFGEdge* newEdge;
@@ -1588,26 +1817,20 @@ void DFG::replaceMultipleDFGEdge(DFGNode* t_old_src, DFGNode* t_old_dst,
     else {
       newEdge = new DFGEdge(dfgEdgeID++, t_new_src[i], t_new_dst[i], target->isCtrlEdge());
     }
-    m_DFGEdges.push_back(newEdge);
+    addDFGEdge(newEdge);
     if (newEdge->isCtrlEdge()){
-      m_ctrlEdges.push_back(newEdge);
+      addCtrlEdge(newEdge);
     }
   }
 }
 
 void DFG::deleteDFGEdge(DFGNode* t_src, DFGNode* t_dst) {
   if (!hasDFGEdge(t_src, t_dst)) return;
-  m_DFGEdges.remove(getDFGEdge(t_src, t_dst));
+  removeDFGEdge(getDFGEdge(t_src, t_dst));
 }
 
 bool DFG::hasDFGEdge(DFGNode* t_src, DFGNode* t_dst) {
-  for (DFGEdge* edge: m_DFGEdges) {
-    if (edge->getSrc() == t_src and
-        edge->getDst() == t_dst) {
-      return true;
-    }
-  }
-  return false;
+  return m_DFGEdgeIndex.find(make_pair(t_src, t_dst)) != m_DFGEdgeIndex.end();
 }
 
 string DFG::changeIns2Str(Instruction* t_ins) {
@@ -1617,6 +1840,12 @@ string DFG::changeIns2Str(Instruction* t_ins) {
   return os.str();
 }
 
+string DFG::describeNode(DFGNode* t_node) {
+  if (t_node->getInst() == NULL)
+    return t_node->getOpcodeName();
+  return changeIns2Str(t_node->getInst());
+}
+
 //get value's name or inst's content
 StringRef DFG::getValueName(Value* t_value) {
   string temp_result = "val";
@@ -1660,13 +1889,13 @@ void DFG::tuneForBitcast() {
   }
 
   for (DFGNode* dfgNode: unnecessaryDFGNodes)
-    nodes.remove(dfgNode);
+    removeNode(dfgNode);
 
   for (DFGEdge* dfgEdge: replaceDFGEdges)
-    m_DFGEdges.remove(dfgEdge);
+    removeDFGEdge(dfgEdge);
 
   for (DFGEdge* dfgEdge: newDFGEdges)
-    m_DFGEdges.push_back(dfgEdge);
+    addDFGEdge(dfgEdge);
 
   connectDFGNodes();
 }
@@ -1698,13 +1927,13 @@ void DFG::tuneForLoad() {
   }
 
   for (DFGNode* dfgNode: unnecessaryDFGNodes)
-    nodes.remove(dfgNode);
+    removeNode(dfgNode);
 
   for (DFGEdge* dfgEdge: removeDFGEdges)
-    m_DFGEdges.remove(dfgEdge);
+    removeDFGEdge(dfgEdge);
 
   for (DFGEdge* dfgEdge: newDFGEdges)
-    m_DFGEdges.push_back(dfgEdge);
+    addDFGEdge(dfgEdge);
 
   connectDFGNodes();
 }
@@ -1733,7 +1962,7 @@ void DFG::tuneForBranch() {
       for (DFGNode* predDFGNode: *(left->getPredNodes())) {
         DFGEdge* newDFGBrEdge = new DFGEdge(newDFGEdgeID++,
             predDFGNode, newDFGBrNode);
-        m_DFGEdges.push_back(newDFGBrEdge);
+        addDFGEdge(newDFGBrEdge);
       }
       nodes.push_back(newDFGBrNode);
       left = newDFGBrNode;
@@ -1752,10 +1981,10 @@ void DFG::tuneForBranch() {
     }
   }
   for (DFGEdge* dfgEdge: replaceDFGEdges) {
-    m_DFGEdges.remove(dfgEdge);
+    removeDFGEdge(dfgEdge);
   }
   for (DFGEdge* dfgEdge: newBrDFGEdges) {
-    m_DFGEdges.push_back(dfgEdge);
+    addDFGEdge(dfgEdge);
   }
 
   connectDFGNodes();
@@ -1786,7 +2015,7 @@ void DFG::trimForStandalone() {
       removeNodes.push_back(dfgNode);
 
   for (DFGNode* dfgNode: removeNodes)
-    nodes.remove(dfgNode);
+    removeNode(dfgNode);
 }
 
 bool DFG::searchDFS(DFGNode* t_target, DFGNode* t_head,
@@ -1808,6 +2037,13 @@ bool DFG::searchDFS(DFGNode* t_target, DFGNode* t_head,
 }
 
 // Used for initializing II for exclusive strategy.
+// Whether the data flowing from the source to the destination belongs to
+// the next iteration, i.e., it feeds a phi that does not follow the source
+// in the program order (the IDs follow the program order).
+bool DFG::isLoopCarried(DFGNode* t_src, DFGNode* t_dst) {
+  return t_dst->isPhiInst() and t_src->getID() >= t_dst->getID();
+}
+
 int DFG::getMaxExecLatency() {
   int max_exec_latency = 0;
   for (DFGNode* dfgNode: nodes) {
@@ -21,6 +21,8 @@
 #include <list>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include <iostream>
 #include <algorithm>
 
@@ -28,6 +30,29 @@
 #include "DFGEdge.h"
 
 using namespace llvm;
+
+typedef pair<DFGNode*, DFGNode*> DFGNodePair;
+
+struct DFGNodePairHash {
+  size_t operator()(const DFGNodePair& t_pair) const {
+    return hash<DFGNode*>()(t_pair.first) * 31 + hash<DFGNode*>()(t_pair.second);
+  }
+};
+
+// The adjacency of the DFG used by the cycle detection, i.e., the edges
+// and their destinations indexed by position, the out edges of each node
+// in the order of the edges, and the strongly connected component of each
+// node, along with the state of the search from one head node.
+struct CycleSearch {
+  vector<DFGEdge*> edges;
+  vector<int> edgeDsts;
+  vector<vector<int>> outEdges;
+  vector<int> components;
+  vector<bool> visitedNodes;
+  vector<bool> erasedEdges;
+  vector<bool> onCurrentCycle;
+  vector<int> currentCycle;
+};
 using namespace std;
 
 class DFG {
@@ -45,14 +70,30 @@ class DFG {
     list<DFGEdge*> m_DFGEdges;
     list<DFGEdge*> m_ctrlEdges;
 
+    // Indices for the constant time lookups, i.e., the node of each
+    // instruction, the edges between each pair of nodes (in the order of
+    // the edge lists) and the position of each data flow edge, which are
+    // updated along with 'nodes', 'm_DFGEdges' and 'm_ctrlEdges'.
+    unordered_map<Value*, DFGNode*> m_valueNodes;
+    unordered_map<DFGNodePair, list<DFGEdge*>, DFGNodePairHash> m_DFGEdgeIndex;
+    unordered_map<DFGNodePair, list<DFGEdge*>, DFGNodePairHash> m_ctrlEdgeIndex;
+    unordered_map<DFGEdge*, list<DFGEdge*>::iterator> m_DFGEdgePositions;
+    void addDFGEdge(DFGEdge*);
+    void removeDFGEdge(DFGEdge*);
+    void addCtrlEdge(DFGEdge*);
+    void removeNode(DFGNode*);
+
     bool m_supportDVFS;
     bool m_DVFSAwareMapping;
 
     string changeIns2Str(Instruction* ins);
+    // The instruction of the node, or its opcode name if the node is read
+    // from dfg.json.
+    string describeNode(DFGNode*);
     //get value's name or inst's content
     StringRef getValueName(Value* v);
-    void DFS_on_DFG(DFGNode*, DFGNode*, list<DFGNode*>*, list<DFGEdge*>*,
-        list<DFGEdge*>*, list<list<DFGEdge*>*>*);
+    void DFS_on_DFG(int, int, CycleSearch*, list<list<DFGEdge*>*>*);
+    void calculateComponents(CycleSearch*);
     DFGNode* getNode(Value*);
     bool hasNode(Value*);
     DFGEdge* getDFGEdge(DFGNode*, DFGNode*);
@@ -92,11 +133,10 @@ class DFG {
     void reorderInASAP();
     void reorderInALAP();
     void reorderInLongest();
-    void reorderDFS(set<DFGNode*>*, list<DFGNode*>*,
-                    list<DFGNode*>*, DFGNode*);
+    int levelize(bool);
+    void sortNodesByLevel(int);
     void initExecLatency(map<string, int>*);
     void initPipelinedOpt(list<string>*);
-    bool isMinimumAndHasNotBeenVisited(set<DFGNode*>*, map<DFGNode*, int>*, DFGNode*);
     // target nonlinear ops
     void nonlinear_combine();
     // target control flows
@@ -106,6 +146,7 @@ class DFG {
   public:
     DFG(Function&, list<Loop*>*, bool, bool, list<string>*, map<string, int>*,
         list<string>*, map<string, list<string>*>*, bool, bool, int t_vectorFactorForIdiv = 4, bool enableDistributed = false);
+    DFG(string, bool, bool, bool);
     list<list<DFGNode*>*>* m_cycleNodeLists;
     //initial ordering of insts
     list<DFGNode*> nodes;
@@ -114,6 +155,7 @@ class DFG {
     list<DFGNode*>* getDFSOrderedNodes();
     int getNodeCount();
     int getMaxExecLatency();
+    bool isLoopCarried(DFGNode*, DFGNode*);
     void construct(Function&);
     void setupCycles();
     list<list<DFGEdge*>*>* calculateCycles();
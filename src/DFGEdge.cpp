@@ -9,6 +9,7 @@
  */
 
 #include "DFGEdge.h"
+#include "Logger.h"
 
 DFGEdge::DFGEdge(int t_id, DFGNode* t_src, DFGNode* t_dst) {
   m_id = t_id;
@@ -63,7 +64,7 @@ bool DFGEdge::isCtrlEdge() {
 
 void DFGEdge::setInterEdge(bool t_isInterEdge) {
   if(m_isCtrlEdge) {
-    cout<<"\033[0;31m"<<"[WARNING] Current DFGEdge is ctrl edge. Set m_isInterEdge = false."<<"\033[0m"<<endl;
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31m"<<"[WARNING] Current DFGEdge is ctrl edge. Set m_isInterEdge = false."<<"\033[0m"<<endl;
     m_isInterEdge = false;
   }
   else {
@@ -9,10 +9,12 @@
  */
 
 #include "DFGNode.h"
+#include "Logger.h"
 #include "llvm/Demangle/Demangle.h"
 
 int testing_opcode_offset = 0;
 string initOpcodeNameHelper(Instruction* inst);
+string initCalledFunctionHelper(Instruction* inst, bool vectorized);
 
 DFGNode::DFGNode(int t_id, bool t_precisionAware, Instruction* t_inst,
                  StringRef t_stringRef, bool t_supportDVFS) {
@@ -27,6 +29,14 @@ DFGNode::DFGNode(int t_id, bool t_precisionAware, Instruction* t_inst,
   } else {
     m_opcodeName = initOpcodeNameHelper(t_inst);
   }
+  // TODO: need a more robust way to recognize vectorized instructions.
+  m_vectorized = cast<Value>(t_inst)->getType()->isVectorTy();
+  m_phiInst = isa<PHINode>(t_inst);
+  m_calledFunction = "";
+  if (m_opcodeName.compare("call") == 0) {
+    m_calledFunction = initCalledFunctionHelper(t_inst, m_vectorized);
+  }
+  m_JSONOpt = "";
   m_isMapped = false;
   m_numConst = 0;
   m_optType = "";
@@ -67,7 +77,7 @@ DFGNode::DFGNode(int t_id, DFGNode* old_node) {
     m_succNodes->push_back(succNode);
   }
   m_opcodeName = old_node->m_opcodeName;
-  m_isMapped = old_node->m_isMapped;
+  m_isMapped = old_node->m_isMapped.load();
   m_numConst = old_node->m_numConst;
   m_optType = old_node->m_optType;
   m_combined = old_node->m_combined;
@@ -86,6 +96,51 @@ DFGNode::DFGNode(int t_id, DFGNode* old_node) {
   m_fuType = old_node->m_fuType;
   m_supportDVFS = old_node->m_supportDVFS;
   m_DVFSLatencyMultiple = old_node->m_DVFSLatencyMultiple;
+  m_vectorized = old_node->m_vectorized;
+  m_phiInst = old_node->m_phiInst;
+  m_calledFunction = old_node->m_calledFunction;
+  m_JSONOpt = old_node->m_JSONOpt;
+}
+
+// Builds the node out of its entry in dfg.json, i.e., the opcode (which is
+// the concatenated one for a fused node), the vectorization, whether it is
+// a phi instruction, the called function, the functional unit, the opt and
+// the number of constant operands. The rest of the entry (e.g., the fusion
+// and the latency) is set by the DFG through the setters.
+DFGNode::DFGNode(int t_id, bool t_precisionAware, string t_opcodeName,
+                 bool t_vectorized, bool t_phiInst, string t_calledFunction,
+                 string t_fuType, string t_JSONOpt, int t_numConst,
+                 bool t_supportDVFS) {
+  m_id = t_id;
+  m_precisionAware = t_precisionAware;
+  m_inst = NULL;
+  m_predNodes = NULL;
+  m_succNodes = NULL;
+  m_opcodeName = t_opcodeName;
+  m_vectorized = t_vectorized;
+  m_phiInst = t_phiInst;
+  m_calledFunction = t_calledFunction;
+  m_isMapped = false;
+  m_numConst = t_numConst;
+  m_optType = "";
+  m_combined = false;
+  m_combinedtype = "";
+  m_isPatternRoot = false;
+  m_patternRoot = NULL;
+  m_critical = false;
+  m_cycleID = new list<int>();
+  m_level = 0;
+  m_execLatency = 1;
+  m_pipelinable = false;
+  m_isPredicatee = false;
+  m_predicatees = NULL;
+  m_isPredicater = false;
+  m_patternNodes = new list<DFGNode*>();
+  initType();
+  m_fuType = t_fuType;
+  m_JSONOpt = t_JSONOpt;
+  m_supportDVFS = t_supportDVFS;
+  m_DVFSLatencyMultiple = 1;
 }
 
 int DFGNode::getID() {
@@ -121,7 +176,7 @@ bool DFGNode::shareSameCycle(DFGNode* t_node) {
   for (int cycleID: *m_cycleID) {
     bool found = (find(my_list->begin(), my_list->end(), cycleID) != my_list->end());
     if (found) {
-      cout<<"[DEBUG] in shareSameCycle is true: node "<<t_node->getID()<<endl;
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] in shareSameCycle is true: node "<<t_node->getID()<<"\n";
       return true;
     }
   }
@@ -157,6 +212,14 @@ list<DFGNode*>* DFGNode::getPredicatees() {
   return m_predicatees;
 }
 
+// Forgets the predicatees and whether the node is predicated, so that the
+// ones read from dfg.json replace the ones added by the control edges.
+void DFGNode::resetPredication() {
+  m_isPredicatee = false;
+  m_predicatees = NULL;
+  m_isPredicater = false;
+}
+
 bool DFGNode::isMapped() {
   return m_isMapped;
 }
@@ -185,9 +248,7 @@ string DFGNode::isCall() {
 }
 
 bool DFGNode::isVectorized() {
-  // TODO: need a more robust way to recognize vectorized instructions.
-  Value* psVal = cast<Value>(m_inst);
-  return psVal->getType()->isVectorTy();
+  return m_vectorized;
 }
 
 bool DFGNode::isLoad() {
@@ -220,6 +281,10 @@ bool DFGNode::isPhi() {
   return false;
 }
 
+bool DFGNode::isPhiInst() {
+  return m_phiInst;
+}
+
 bool DFGNode::isOpt(string t_opt) {
   if (m_opcodeName.compare(t_opt) == 0)
     return true;
@@ -263,7 +328,7 @@ bool DFGNode::isScalarAddSub() {
 }
 
 bool DFGNode::isConstantAddSub() {
-  if (auto* addInst = dyn_cast<BinaryOperator>(m_inst)) {
+  if (auto* addInst = dyn_cast_or_null<BinaryOperator>(m_inst)) {
       if (addInst->getOpcode() == Instruction::Add) {
           Value* op1 = addInst->getOperand(0);
           Value* op2 = addInst->getOperand(1);
@@ -387,33 +452,10 @@ string DFGNode::getOpcodeName() {
       result = "cmp";
     } else if (m_opcodeName.compare("fdiv") == 0) {
       result = "div";
-    } else if (m_opcodeName.compare("call") == 0 && isVectorized()) {
-
-      Function *func = ((CallInst*)m_inst)->getCalledFunction();
-      if (func) {
-        string newName = func->getName().str();
-        string removingPattern = "llvm.vector.";
-        int pos = newName.find(removingPattern);
-        if (pos == -1)
-        pos = newName.find("llvm.");
-	      newName.erase(pos, removingPattern.length());
-        string delimiter = ".v";
-        newName = newName.substr(0, newName.find(delimiter));
-	      replace(newName.begin(), newName.end(), '.', '_');
-        return newName;
-      }
-      else
-        return "indirect call";
     }
     // for the special operations
     else if (m_opcodeName.compare("call") == 0) {
-      Function *func = ((CallInst*)m_inst)->getCalledFunction();
-      if (func) {
-        string newName = func->getName().str();
-        newName = demangle(newName);
-        return newName.substr(0, newName.find("("));
-      }
-      else return "indirect call";
+      return m_calledFunction;
     }
   }
 
@@ -428,11 +470,22 @@ string DFGNode::getPathName() {
   return m_pathName;
 }
 
+string DFGNode::getRawOpcodeName() {
+  return m_opcodeName;
+}
+
+string DFGNode::getCalledFunction() {
+  return m_calledFunction;
+}
+
 string DFGNode::getFuType() {
   return m_fuType;
 }
 
 string DFGNode::getJSONOpt() {
+  if (m_JSONOpt != "") {
+    return m_JSONOpt;
+  }
 
   int numPred = 0;
   for (DFGEdge* edge: m_inEdges) {
@@ -495,6 +548,10 @@ void DFGNode::setPipelinable() {
   m_pipelinable = true;
 }
 
+int DFGNode::getRawExecLatency() {
+  return m_execLatency;
+}
+
 bool DFGNode::isPipelinable() {
   return m_pipelinable;
 }
@@ -780,6 +837,28 @@ string initOpcodeNameHelper(Instruction* inst) {
   return "unknown";
 }
 
+// Returns the name shown for the called function, i.e., the demangled name
+// or the name of the vector intrinsic without the type suffix.
+string initCalledFunctionHelper(Instruction* inst, bool vectorized) {
+  Function *func = ((CallInst*)inst)->getCalledFunction();
+  if (!func)
+    return "indirect call";
+  string newName = func->getName().str();
+  if (vectorized) {
+    string removingPattern = "llvm.vector.";
+    int pos = newName.find(removingPattern);
+    if (pos == -1)
+      pos = newName.find("llvm.");
+    newName.erase(pos, removingPattern.length());
+    string delimiter = ".v";
+    newName = newName.substr(0, newName.find(delimiter));
+    replace(newName.begin(), newName.end(), '.', '_');
+    return newName;
+  }
+  newName = demangle(newName);
+  return newName.substr(0, newName.find("("));
+}
+
 void DFGNode::setBBID(int t_bbID) {
   m_bbID = t_bbID;
 }
@@ -22,6 +22,7 @@
 #include <list>
 #include <stdio.h>
 #include <iostream>
+#include <atomic>
 
 #include "DFGEdge.h"
 #define MAXIMUM_COMBINED_TYPE 100
@@ -49,7 +50,8 @@ class DFGNode {
     list<DFGNode*>* m_predNodes;
     list<DFGNode*>* m_patternNodes;
     list<int>* m_cycleID;
-    bool m_isMapped;
+    // Atomic as the DFG is shared by the concurrent mapping attempts.
+    std::atomic<bool> m_isMapped;
     int m_numConst;
     string m_optType;
     string m_fuType;
@@ -75,9 +77,19 @@ class DFGNode {
     // "m_bbID" is used to specify which basicblock is this DFGNode in.
     int m_bbID;
 
+    // Facts of the LLVM instruction, which are kept along with the node so
+    // that the nodes read from dfg.json (i.e., without the instruction)
+    // behave the same.
+    bool m_vectorized;
+    bool m_phiInst;
+    string m_calledFunction;
+    // The opt read from dfg.json, which overrides the derived one.
+    string m_JSONOpt;
+
   public:
     DFGNode(int, bool, Instruction*, StringRef, bool);
     DFGNode(int, DFGNode* old_node);
+    DFGNode(int, bool, string, bool, bool, string, string, string, int, bool);
     int getID();
     void setID(int);
     void setLevel(int);
@@ -91,6 +103,9 @@ class DFGNode {
     string isCall();
     bool isBranch();
     bool isPhi();
+    // Whether the node is built from a phi instruction, including the fused
+    // ones rooted at a phi, unlike isPhi().
+    bool isPhiInst();
     bool isAddSub();
     bool isScalarAddSub();
     bool isConstantAddSub();
@@ -114,6 +129,10 @@ class DFGNode {
     Instruction* getInst();
     StringRef getStringRef();
     string getOpcodeName();
+    // The opcode as kept in the node, i.e., neither renamed as shown nor
+    // prefixed for the vectorization.
+    string getRawOpcodeName();
+    string getCalledFunction();
     string getPathName();
     list<DFGNode*>* getPredNodes();
     list<DFGNode*>* getSuccNodes();
@@ -145,6 +164,7 @@ class DFGNode {
     list<int>* getCycleIDs();
     void addPredicatee(DFGNode*);
     list<DFGNode*>* getPredicatees();
+    void resetPredication();
     void setPredicatee();
     bool isPredicatee();
     bool isPredicater();
@@ -152,6 +172,8 @@ class DFGNode {
     void setExecLatency(int);
     bool isMultiCycleExec(int);
     int getExecLatency(int);
+    // The latency regardless of the DVFS level.
+    int getRawExecLatency();
     void setPipelinable();
     bool isPipelinable();
     bool shareFU(DFGNode*);
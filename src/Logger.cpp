@@ -0,0 +1,35 @@
+/*
+ * ======================================================================
+ * Logger.cpp
+ * ======================================================================
+ * Leveled logging implementation.
+ *
+ * Author : agent
+ *   Date : Oct 18, 2026
+ */
+
+#include "Logger.h"
+
+// Only the results are logged by default, as the debug and trace messages
+// dominate the runtime of the mapping.
+int mapperLogLevel = LOG_LEVEL_INFO;
+
+// Sets the runtime level by its name. Returns false for an unknown name,
+// in which case the level is kept.
+bool setLogLevel(string t_name) {
+  string names[] = {"off", "error", "info", "debug", "trace"};
+  for (int level=LOG_LEVEL_OFF; level<=LOG_LEVEL_TRACE; ++level) {
+    if (t_name.compare(names[level]) == 0) {
+      mapperLogLevel = level;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Unties cout from the C stdio, so that the messages are buffered in cout
+// rather than handed to stdout one by one. Nothing in the mapper writes to
+// stdout through the C stdio, so the order of the messages is kept.
+void bufferLogging() {
+  ios::sync_with_stdio(false);
+}
@@ -0,0 +1,49 @@
+/*
+ * ======================================================================
+ * Logger.h
+ * ======================================================================
+ * Leveled logging implementation header file.
+ *
+ * Author : agent
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef Logger_H
+#define Logger_H
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+#define LOG_LEVEL_OFF   0 // Nothing is logged
+#define LOG_LEVEL_ERROR 1 // Invalid inputs and failures
+#define LOG_LEVEL_INFO  2 // Results, e.g., the II and the schedule
+#define LOG_LEVEL_DEBUG 3 // Progress of the DFG construction and mapping
+#define LOG_LEVEL_TRACE 4 // Every placement, route and resource occupancy
+
+// The most verbose level compiled in, e.g., -DMAPPER_LOG_LEVEL=2 removes
+// the debug and trace messages from the build.
+#ifndef MAPPER_LOG_LEVEL
+#define MAPPER_LOG_LEVEL LOG_LEVEL_TRACE
+#endif
+
+// The most verbose level logged at runtime, which is set by the "logLevel"
+// in param.json.
+extern int mapperLogLevel;
+
+bool setLogLevel(string);
+void bufferLogging();
+
+inline bool isLogging(int t_level) {
+  return t_level <= MAPPER_LOG_LEVEL and t_level <= mapperLogLevel;
+}
+
+// Streams a message into the given stream only if its level is logged, so
+// that a skipped message costs a single comparison without evaluating its
+// operands. The messages are not flushed (i.e., no endl) except the errors,
+// leaving the buffering to the stream.
+#define LOG_TO(t_level, t_stream) if (!isLogging(t_level)) ; else t_stream
+#define LOG(t_level) LOG_TO(t_level, cout)
+
+#endif
@@ -9,7 +9,11 @@
  */
 
 #include "Mapper.h"
+#include "Logger.h"
+#include "MapperStats.h"
+#include "ConfigBinary.h"
 #include "json.hpp"
+#include <cfloat>
 #include <cmath>
 #include <iostream>
 #include <string>
@@ -17,13 +21,41 @@
 #include <map>
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <omp.h>
+#include <climits>
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 //#include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
 Mapper::Mapper(bool t_DVFSAwareMapping) {
   m_DVFSAwareMapping = t_DVFSAwareMapping;
+  m_IISweepWidth = 1;
+  m_searchTimeLimit = 0;
+  m_searchExpansionLimit = 0;
+  m_searchBacktrackLimit = 0;
+  m_searchTaskDepth = 0;
+  m_searchMinimizeRouting = false;
+  m_search = NULL;
+  m_routingCost = 0;
+  m_negotiatedRouting = false;
+  m_negotiationIterations = 1;
+  m_repairAttempts = 0;
+  m_refinementTimeLimit = 0;
+  m_binaryConfig = false;
+}
+
+Mapper::~Mapper() {
+  for (Router* router: m_routers) {
+    delete router;
+  }
+}
+
+void Mapper::setIISweepWidth(int t_IISweepWidth) {
+  m_IISweepWidth = t_IISweepWidth;
 }
 
 int Mapper::getResMII(DFG* t_dfg, CGRA* t_cgra) {
@@ -34,22 +66,80 @@ int Mapper::getResMII(DFG* t_dfg, CGRA* t_cgra) {
   return ResMII;
 }
 
+// RecMII is the maximum cycle ratio of the DFG, i.e., MAX(delay(c) /
+// distance(c)) over its cycles, where the delay sums up the execution
+// latencies and the distance counts the loop-carried edges. It is the
+// smallest II that leaves no cycle with a positive delay - II * distance,
+// which is found by a binary search over the II with the positive cycles
+// detected by Bellman-Ford, so the cycles are never enumerated.
 int Mapper::getRecMII(DFG* t_dfg) {
-  float RecMII = 0.0;
-  float temp_RecMII = 0.0;
-  list<list<DFGNode*>*>* cycles = t_dfg->getCycleLists(); //calculateCycles();
-  // cout<<"... number of cycles: "<<cycles->size()<<" ..."<<endl;
-  // TODO: RecMII = MAX (delay(c) / distance(c))
-  for( list<DFGNode*>* cycle: *cycles) {
-    temp_RecMII = float(cycle->size()) / 1.0;
-    // cout << "... [DEBUG] cycle length " << temp_RecMII << "..." <<endl;
-    // for (DFGNode* dfgNode: *cycle){
-    //   cout << "... [DEBUG] cycle nodes " << dfgNode->getID() << " "<< dfgNode->getOpcodeName() << " ";
-    // }
-    if(temp_RecMII > RecMII)
-      RecMII = temp_RecMII;
-  }
-  return ceil(RecMII);
+  map<DFGNode*, int> nodeIndices;
+  for (DFGNode* node: t_dfg->nodes) {
+    nodeIndices.insert(make_pair(node, nodeIndices.size()));
+  }
+  vector<int> srcs;
+  vector<int> dsts;
+  vector<int> delays;
+  vector<int> distances;
+  vector<int> fallbackDistances;
+  int maxRecMII = 1;
+  for (DFGNode* node: t_dfg->nodes) {
+    int latency = node->getExecLatency(node->getDVFSLatencyMultiple());
+    maxRecMII += latency;
+    for (DFGNode* succNode: *(node->getSuccNodes())) {
+      if (nodeIndices.find(succNode) == nodeIndices.end())
+        continue;
+      srcs.push_back(nodeIndices[node]);
+      dsts.push_back(nodeIndices[succNode]);
+      delays.push_back(latency);
+      distances.push_back(t_dfg->isLoopCarried(node, succNode) ? 1 : 0);
+      // Any cycle has at least one edge that does not follow the program
+      // order, which bounds the ratio in case a cycle misses its phi.
+      fallbackDistances.push_back(node->getID() >= succNode->getID() ? 1 : 0);
+    }
+  }
+  if (hasPositiveCycle(nodeIndices.size(), &srcs, &dsts, &delays,
+                       &distances, maxRecMII)) {
+    LOG(LOG_LEVEL_INFO) << "[WARNING] found a cycle without loop-carried edge, RecMII is bounded by the program order\n";
+    distances.swap(fallbackDistances);
+  }
+  int lower = 0;
+  int upper = maxRecMII;
+  while (upper - lower > 1) {
+    int II = (lower + upper) / 2;
+    if (hasPositiveCycle(nodeIndices.size(), &srcs, &dsts, &delays,
+                         &distances, II))
+      lower = II;
+    else
+      upper = II;
+  }
+  // No cycle at all leaves the RecMII as 0, as before.
+  if (!hasPositiveCycle(nodeIndices.size(), &srcs, &dsts, &delays,
+                        &distances, 0))
+    return 0;
+  return upper;
+}
+
+// Whether any cycle has a positive delay - II * distance, i.e., Bellman-
+// Ford on the longest paths still relaxes some edge after V rounds.
+bool Mapper::hasPositiveCycle(int t_nodeCount, vector<int>* t_srcs,
+    vector<int>* t_dsts, vector<int>* t_delays, vector<int>* t_distances,
+    int t_II) {
+  vector<long> lengths(t_nodeCount, 0);
+  for (int round=0; round<=t_nodeCount; ++round) {
+    bool relaxed = false;
+    for (int i=0; i<t_srcs->size(); ++i) {
+      long length = lengths[(*t_srcs)[i]] + (*t_delays)[i] -
+                    (long)t_II * (*t_distances)[i];
+      if (length > lengths[(*t_dsts)[i]]) {
+        lengths[(*t_dsts)[i]] = length;
+        relaxed = true;
+      }
+    }
+    if (!relaxed)
+      return false;
+  }
+  return true;
 }
 
 int Mapper::getExpandableII(DFG* t_dfg, int t_ii) {
@@ -58,131 +148,98 @@ int Mapper::getExpandableII(DFG* t_dfg, int t_ii) {
   return std::max(rec_mii, ceiled);
 }
 
+// Creates one router per thread for the given CGRA.
+void Mapper::initRouters(CGRA* t_cgra, int t_threadCount) {
+  for (Router* router: m_routers) {
+    delete router;
+  }
+  m_routers.clear();
+  for (int i=0; i<t_threadCount; ++i) {
+    m_routers.push_back(new Router(t_cgra));
+  }
+}
+
 void Mapper::constructMRRG(DFG* t_dfg, CGRA* t_cgra, int t_II) {
-  m_mapping.clear();
-  m_mappingTiming.clear();
+  ScopedTimer timer(STATS_CONSTRUCT_MRRG);
+  if (m_routers.size() == 0 or m_routers[0]->getCGRA() != t_cgra)
+    initRouters(t_cgra, omp_get_max_threads());
+  m_linkHistory.clear();
+  setCongestion(NULL, 0);
+  clearMapping(t_cgra);
   t_cgra->constructMRRG(t_II);
   m_maxMappingCycle = t_cgra->getFUCount()*t_II*t_II;
+  m_dfgNodeOrder.clear();
   for (DFGNode* dfgNode: t_dfg->nodes) {
     dfgNode->clearMapped();
+    m_dfgNodeOrder[dfgNode] = m_dfgNodeOrder.size();
   }
 }
 
+// Whether the first DFG node is placed before the second one in the
+// mapping order. A DFG node is timed by its mapped predecessors, which
+// always precede it unless it is placed again after being unscheduled.
+bool Mapper::precedes(DFGNode* t_a, DFGNode* t_b) {
+  return m_dfgNodeOrder.at(t_a) < m_dfgNodeOrder.at(t_b);
+}
+
+// Whether both critical DFG nodes are within the same cycle of the DFG,
+// whose routes must not violate the II.
+bool Mapper::isInSameCycle(DFGNode* t_a, DFGNode* t_b) {
+  return t_a->shareSameCycle(t_b) and t_a->isCritical() and t_b->isCritical();
+}
+
+Router* Mapper::getRouter() {
+  return m_routers[omp_get_thread_num()];
+}
+
 // The arriving data can stay inside the input buffer
-map<CGRANode*, int>* Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
+bool Mapper::dijkstra_search(CGRA* t_cgra, DFG* t_dfg,
     int t_II, DFGNode* t_srcDFGNode, DFGNode* t_targetDFGNode,
-    CGRANode* t_dstCGRANode) {
-  list<CGRANode*> searchPool;
-  map<CGRANode*, int> distance;
-  map<CGRANode*, int> timing;
-  map<CGRANode*, CGRANode*> previous;
-  CGRANode* srcCGRANode = m_mapping[t_srcDFGNode];
-  timing[srcCGRANode] = m_mappingTiming[t_srcDFGNode];
-  for (int i=0; i<t_cgra->getRows(); ++i) {
-    for (int j=0; j<t_cgra->getColumns(); ++j) {
-      CGRANode* node = t_cgra->nodes[i][j];
-      distance[node] = m_maxMappingCycle;
-      timing[node] = m_mappingTiming[t_srcDFGNode];
-      timing[node] += t_srcDFGNode->getExecLatency(node->getDVFSLatencyMultiple()) - 1;
-//      if (t_srcDFGNode->isLoad() or t_srcDFGNode->isStore()) {
-//        timing[node] += 1;
-//      }
-      // TODO: should also consider the xbar here?
-//      if (!cgra->nodes[i][j]->canOccupyFU(timing[node], II)) {
-//        int temp_cycle = timing[node];
-//        timing[node] = m_maxMappingCycle;
-//        while (temp_cycle < m_maxMappingCycle) {
-//          if (cgra->nodes[i][j]->canOccupyFU(temp_cycle, II)) {
-//            timing[node] = temp_cycle;
-//            break;
-//          }
-//          ++temp_cycle;
-//        }
-//      }
-      previous[node] = NULL;
-      searchPool.push_back(t_cgra->nodes[i][j]);
-    }
-  }
-  distance[m_mapping[t_srcDFGNode]] = 0;
-  while (searchPool.size() != 0) {
-    int minCost = m_maxMappingCycle + 1;
-    CGRANode* minNode;
-    for (CGRANode* currentNode: searchPool) {
-      if (distance[currentNode] < minCost) {
-        minCost = distance[currentNode];
-        minNode = currentNode;
-      }
-    }
-    assert(minNode != NULL);
-    searchPool.remove(minNode);
-    // found the target point in the shortest path
-    if (minNode == t_dstCGRANode) {
-      timing[t_dstCGRANode] = minNode->getMinIdleCycle(t_targetDFGNode, timing[minNode], t_II);
-      break;
-    }
-    list<CGRANode*>* currentNeighbors = minNode->getNeighbors();
-//    cout<<"DEBUG no need?"<<endl;
-
-    for (CGRANode* neighbor: *currentNeighbors) {
-      int cycle = timing[minNode];
-      while (1) {
-        CGRALink* currentLink = minNode->getOutLink(neighbor);
-        // TODO: should also consider the cost of the register file
-        if (currentLink->canOccupy(t_srcDFGNode, srcCGRANode, cycle, t_II)) {
-          // rough estimate the cost based on the suspend cycle
-          int cost = distance[minNode] + (cycle - timing[minNode]) + 1;
-          if (cost < distance[neighbor]) {
-            distance[neighbor] = cost;
-            timing[neighbor] = cycle + 1;
-            previous[neighbor] = minNode;
-          }
-          break;
-        }
-        ++cycle;
-        if(cycle > m_maxMappingCycle)
-          break;
-      }
-    }
-  }
+    CGRANode* t_dstCGRANode, MappingPath* t_path) {
+  ScopedTimer timer(STATS_DIJKSTRA);
+  Router* router = getRouter();
+  // The candidate tiles are evaluated concurrently, so the mapping is
+  // only accessed through the non-inserting lookups.
+  CGRANode* srcCGRANode = m_mapping.at(t_srcDFGNode);
+  // TODO: should also consider the xbar here?
+  router->init(t_srcDFGNode, m_mappingTiming.at(t_srcDFGNode), m_maxMappingCycle);
+  router->search(t_srcDFGNode, srcCGRANode, t_dstCGRANode, t_II);
+  router->setTiming(t_dstCGRANode, t_dstCGRANode->getMinIdleCycle(
+      t_targetDFGNode, router->getTiming(t_dstCGRANode), t_II));
 
   // Get the shortest path.
-  map<CGRANode*, int>* path = new map<CGRANode*, int>();
-  CGRANode* u = t_dstCGRANode;
-  if (previous[u] != NULL or u == m_mapping[t_srcDFGNode]) {
-    while (u != NULL) {
-      (*path)[u] = timing[u];
-      u = previous[u];
-    }
-  }
-  if (timing[t_dstCGRANode] > m_maxMappingCycle or
+  if (!router->buildPath(srcCGRANode, t_dstCGRANode, t_path))
+    return false;
+  if (router->getTiming(t_dstCGRANode) > m_maxMappingCycle or
       !t_dstCGRANode->canOccupy(t_targetDFGNode,
-      timing[t_dstCGRANode], t_II)) {
-//    path.clear();
-    delete path;
-    return NULL;
+      router->getTiming(t_dstCGRANode), t_II)) {
+    return false;
   }
-  return path;
+  return true;
 }
 
-list<map<CGRANode*, int>*>* Mapper::getOrderedPotentialPaths(CGRA* t_cgra,
-    DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths) {
-  map<map<CGRANode*, int>*, float>* pathsWithCost =
-      new map<map<CGRANode*, int>*, float>();
-  for (list<map<CGRANode*, int>*>::iterator path=t_paths->begin();
-      path!=t_paths->end(); ++path) {
-    if ((*path)->size() == 0)
-      continue;
-
-    map<int, CGRANode*>* reorderPath = getReorderPath(*path);
-//    for (map<CGRANode*, int>::iterator rp=(*path)->begin(); rp!=(*path)->end(); ++rp)
-//      reorderPath[(*rp).second] = (*rp).first;
-//    assert(reorderPath.size() == (*path)->size());
+// Ties on the cost are broken by the order of the candidates (i.e., the
+// tile order) rather than by their addresses, so the ranking does not
+// depend on how the threads allocate the paths.
+static bool isCheaper(const PathCost& t_a, const PathCost& t_b) {
+  if (t_a.cost != t_b.cost)
+    return t_a.cost < t_b.cost;
+  return t_a.order < t_b.order;
+}
 
-    map<int, CGRANode*>::reverse_iterator riter=reorderPath->rbegin();
+// Scores each non-empty candidate path into 't_costs'.
+void Mapper::scorePotentialPaths(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, vector<MappingPath>* t_paths,
+    vector<PathCost>* t_costs) {
+  t_costs->clear();
+  for (int order=0; order<t_paths->size(); ++order) {
+    MappingPath* path = &(*t_paths)[order];
+    if (path->size() == 0)
+      continue;
 
-    int distanceCost = (*riter).first;
-    CGRANode* targetCGRANode = (*riter).second;
-    int targetCycle = (*riter).first;
+    int distanceCost = path->getTarget().cycle;
+    CGRANode* targetCGRANode = path->getTarget().tile;
+    int targetCycle = path->getTarget().cycle;
     if (distanceCost >= m_maxMappingCycle)
       continue;
 //    if (t_dfgNode->getID() == 2 or t_dfgNode->getID() == 1) {
@@ -192,25 +249,20 @@ list<map<CGRANode*, int>*>* Mapper::getOrderedPotentialPaths(CGRA* t_cgra,
     float cost = distanceCost + 1;
 
     // Consider the same tile mapped with continuously two DFG nodes.
-    map<int, CGRANode*>::iterator lastCGRANodeItr=reorderPath->begin();
-    for (map<int, CGRANode*>::iterator cgraNodeItr=reorderPath->begin();
-        cgraNodeItr!=reorderPath->end(); ++cgraNodeItr) {
-      if (cgraNodeItr != reorderPath->begin()) {
-        int lastCycle = (*lastCGRANodeItr).first;
-        int currentCycle = (*cgraNodeItr).first;
-        int delta = currentCycle - lastCycle;
-        if (delta > 1) {
-          cost = cost + 1.5;
-        }
+    for (int i=1; i<path->size(); ++i) {
+      int lastCycle = path->getHop(i-1).cycle;
+      int currentCycle = path->getHop(i).cycle;
+      int delta = currentCycle - lastCycle;
+      if (delta > 1) {
+        cost = cost + 1.5;
       }
-      lastCGRANodeItr = cgraNodeItr;
     }
 
     // Consider the single tile that processes everything. FIXME: this is
-    // actually a bug because we use map<CGRANode*, int> rather than
-    // map<int, CGRANode*>, in which case the different cycles's execution
-    // will be wrongly merged into one.
-    if (reorderPath->size() == 1) {
+    // actually a bug because the source and the target on the same tile
+    // are kept as a single hop, in which case the different cycles's
+    // execution will be wrongly merged into one.
+    if (path->size() == 1) {
       cost += 2;
     }
 
@@ -275,13 +327,12 @@ list<map<CGRANode*, int>*>* Mapper::getOrderedPotentialPaths(CGRA* t_cgra,
 
     // Consider the cost of that the DFG node with multiple successor
     // might potentially occupy the surrounding CGRA nodes.
+    // The penalty is accumulated per DFG node to keep the same rounding.
     list<CGRANode*>* neighbors = targetCGRANode->getNeighbors();
     for (CGRANode* neighbor: *neighbors) {
-      list<DFGNode*>* dfgNodes = getMappedDFGNodes(t_dfg, neighbor);
-      for (DFGNode* dfgNode: *dfgNodes) {
-        if (dfgNode->getSuccNodes()->size() > 2) {
-          cost += 0.4;
-        }
+      int highFanouts = m_tileHighFanouts[neighbor->getID()];
+      for (int i=0; i<highFanouts; ++i) {
+        cost += 0.4;
       }
     }
 
@@ -294,97 +345,130 @@ list<map<CGRANode*, int>*>* Mapper::getOrderedPotentialPaths(CGRA* t_cgra,
 
     // Consider the bonus of reusing the same link for delivery the
     // same data to different destination CGRA nodes (multicast).
-    lastCGRANodeItr=reorderPath->begin();
-    for (map<int, CGRANode*>::iterator cgraNodeItr=reorderPath->begin();
-        cgraNodeItr!=reorderPath->end(); ++cgraNodeItr) {
-      if (cgraNodeItr != reorderPath->begin()) {
-        CGRANode* left = (*lastCGRANodeItr).second;
-        CGRANode* right = (*cgraNodeItr).second;
-        int leftCycle = (*lastCGRANodeItr).first;
-//        cout<<"$$$$$$$$$$ wrong?! left node: "<<left->getID()<<" -> right node: "<<right->getID()<<endl;
-        CGRALink* l = left->getOutLink(right);
-        if (l != NULL and l->isReused(leftCycle)) {
-          cost -= 0.5;
-        }
+    for (int i=1; i<path->size(); ++i) {
+      CGRANode* left = path->getHop(i-1).tile;
+      CGRANode* right = path->getHop(i).tile;
+      int leftCycle = path->getHop(i-1).cycle;
+//      cout<<"$$$$$$$$$$ wrong?! left node: "<<left->getID()<<" -> right node: "<<right->getID()<<endl;
+      CGRALink* l = left->getOutLink(right);
+      if (l != NULL and l->isReused(leftCycle)) {
+        cost -= 0.5;
       }
-      lastCGRANodeItr = cgraNodeItr;
     }
 
     // Consider the bonus of available links on the target CGRA nodes.
-    cost -= targetCGRANode->getOccupiableInLinks(targetCycle, t_II)->size()*0.3 +
-        targetCGRANode->getOccupiableOutLinks(targetCycle, t_II)->size()*0.3;
+    cost -= targetCGRANode->getOccupiableInLinks(targetCycle, t_II).size()*0.3 +
+        targetCGRANode->getOccupiableOutLinks(targetCycle, t_II).size()*0.3;
 
-    (*pathsWithCost)[*path] = cost;
+    PathCost pathCost = {cost, order, path};
+    t_costs->push_back(pathCost);
   }
+  addStatsCount(STATS_CANDIDATE_PATHS, t_costs->size());
+}
 
-  list<map<CGRANode*, int>*>* potentialPaths = new list<map<CGRANode*, int>*>();
-  while(pathsWithCost->size() != 0) {
-    float minCost = (*pathsWithCost->begin()).second;
-    map<CGRANode*, int>* currentPath = (*pathsWithCost->begin()).first;
-    for (map<map<CGRANode*, int>*, float>::iterator pathItr=pathsWithCost->begin();
-        pathItr!=pathsWithCost->end(); ++pathItr) {
-      if ((*pathItr).second < minCost) {
-        minCost = (*pathItr).second;
-        currentPath = (*pathItr).first;
-      }
-    }
-    pathsWithCost->erase(currentPath);
-    potentialPaths->push_back(currentPath);
+// Orders all the candidate paths by their costs, which is needed by the
+// exhaustive search to try the alternatives one by one.
+vector<MappingPath*> Mapper::getOrderedPotentialPaths(CGRA* t_cgra,
+    DFG* t_dfg, int t_II, DFGNode* t_dfgNode, vector<MappingPath>* t_paths) {
+  vector<PathCost> costs;
+  scorePotentialPaths(t_cgra, t_dfg, t_II, t_dfgNode, t_paths, &costs);
+  std::sort(costs.begin(), costs.end(), isCheaper);
+
+  vector<MappingPath*> potentialPaths;
+  for (PathCost& pathCost: costs) {
+    potentialPaths.push_back(pathCost.path);
   }
-
-  delete pathsWithCost;
   return potentialPaths;
 }
 
-map<CGRANode*, int>* Mapper::getPathWithMinCostAndConstraints(CGRA* t_cgra,
-    DFG* t_dfg, int t_II, DFGNode* t_dfgNode, list<map<CGRANode*, int>*>* t_paths) {
+// Only the cheapest candidate path is needed by the heuristic, so the
+// candidates are not ordered at all.
+MappingPath* Mapper::getPathWithMinCostAndConstraints(CGRA* t_cgra,
+    DFG* t_dfg, int t_II, DFGNode* t_dfgNode, vector<MappingPath>* t_paths) {
+  vector<PathCost> costs;
+  scorePotentialPaths(t_cgra, t_dfg, t_II, t_dfgNode, t_paths, &costs);
+  if (costs.size() == 0)
+    return NULL;
+  return std::min_element(costs.begin(), costs.end(), isCheaper)->path;
+}
 
-  list<map<CGRANode*, int>*>* potentialPaths =
-      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, t_dfgNode, t_paths);
+list<DFGNode*>* Mapper::getMappedDFGNodes(CGRANode* t_cgraNode) {
+  return &m_tileDFGNodes[t_cgraNode->getID()];
+}
 
-  // The paths are already ordered well based on the cost in getPotentialPaths().
-  list<map<CGRANode*, int>*>::iterator pathItr=potentialPaths->begin();
-  return (*pathItr);
+// A DFG node is a high fanout one if it has more than two successors,
+// which potentially occupies the surrounding tiles for the delivery.
+bool Mapper::isHighFanout(DFGNode* t_dfgNode) {
+  return t_dfgNode->getSuccNodes()->size() > 2;
 }
 
-list<DFGNode*>* Mapper::getMappedDFGNodes(DFG* t_dfg, CGRANode* t_cgraNode) {
-  list<DFGNode*>* dfgNodes = new list<DFGNode*>();
-  for (DFGNode* dfgNode: t_dfg->nodes) {
-    if (m_mapping.find(dfgNode) != m_mapping.end())
-      if ( m_mapping[dfgNode] == t_cgraNode)
-        dfgNodes->push_back(dfgNode);
+void Mapper::removeMapping(DFGNode* t_dfgNode) {
+  map<DFGNode*, CGRANode*>::iterator it = m_mapping.find(t_dfgNode);
+  if (it == m_mapping.end())
+    return;
+  m_tileDFGNodes[it->second->getID()].remove(t_dfgNode);
+  if (isHighFanout(t_dfgNode))
+    --m_tileHighFanouts[it->second->getID()];
+  m_mapping.erase(it);
+  m_mappingTiming.erase(t_dfgNode);
+  t_dfgNode->clearMapped();
+}
+
+void Mapper::clearMapping(CGRA* t_cgra) {
+  m_mapping.clear();
+  m_mappingTiming.clear();
+  m_tileDFGNodes.assign(t_cgra->getFUCount(), list<DFGNode*>());
+  m_tileHighFanouts.assign(t_cgra->getFUCount(), 0);
+  m_routingCost = 0;
+}
+
+// Maps the DFG node onto the tile and keeps the reverse index up to date.
+void Mapper::setMapping(DFGNode* t_dfgNode, CGRANode* t_cgraNode) {
+  map<DFGNode*, CGRANode*>::iterator it = m_mapping.find(t_dfgNode);
+  if (it != m_mapping.end()) {
+    m_tileDFGNodes[it->second->getID()].remove(t_dfgNode);
+    if (isHighFanout(t_dfgNode))
+      --m_tileHighFanouts[it->second->getID()];
   }
-  return dfgNodes;
+  m_mapping[t_dfgNode] = t_cgraNode;
+  m_tileDFGNodes[t_cgraNode->getID()].push_back(t_dfgNode);
+  if (isHighFanout(t_dfgNode))
+    ++m_tileHighFanouts[t_cgraNode->getID()];
 }
 
 // TODO: will grant award for the overuse the same link for the
 //       same data delivery
-map<CGRANode*, int>* Mapper::calculateCost(CGRA* t_cgra, DFG* t_dfg,
-    int t_II, DFGNode* t_dfgNode, CGRANode* t_fu) {
+// The path towards the latest predecessor is kept in 't_path', which
+// stays empty if the DFG node cannot be placed onto 't_fu'.
+bool Mapper::calculateCost(CGRA* t_cgra, DFG* t_dfg,
+    int t_II, DFGNode* t_dfgNode, CGRANode* t_fu, MappingPath* t_path) {
+  ScopedTimer timer(STATS_CALCULATE_COST);
   //cout<<"...calculateCost() for dfgNode "<<t_dfgNode->getID()<<" on tile "<<t_fu->getID()<<endl;
-  map<CGRANode*, int>* path = NULL;
+  t_path->clear();
   list<DFGNode*>* predNodes = t_dfgNode->getPredNodes();
   int latest = -1;
   bool isAnyPredDFGNodeMapped = false;
+  MappingPath tempPath;
 
   for(DFGNode* pre: *predNodes) {
 //      cout<<"[DEBUG] how dare to pre node: "<<pre->getID()<<"; CGRA node: "<<t_fu->getID()<<endl;
-    if(m_mapping.find(pre) != m_mapping.end()) {
+    // The predecessors placed after the DFG node deliver their data to
+    // the next iterations, which does not time the DFG node.
+    if(m_mapping.find(pre) != m_mapping.end() and precedes(pre, t_dfgNode)) {
       // Leverage Dijkstra algorithm to search the shortest path between
       // the mapped 'CGRANode' of the 'pre' and the target 'fu'.
-      map<CGRANode*, int>* tempPath = NULL;
-      if (t_fu->canSupport(t_dfgNode))
-        tempPath = dijkstra_search(t_cgra, t_dfg, t_II, pre,
-            t_dfgNode, t_fu);
-      if (tempPath == NULL)
-        return NULL;
-      else if ((*tempPath)[t_fu] >= m_maxMappingCycle) {
-        delete tempPath;
-        return NULL;
-      }
-      if ((*tempPath)[t_fu] > latest) {
-        latest = (*tempPath)[t_fu];
-        path = tempPath;
+      if (!t_fu->canSupport(t_dfgNode) or
+          !dijkstra_search(t_cgra, t_dfg, t_II, pre, t_dfgNode, t_fu,
+                           &tempPath)) {
+        t_path->clear();
+        return false;
+      } else if (tempPath.getTarget().cycle >= m_maxMappingCycle) {
+        t_path->clear();
+        return false;
+      }
+      if (tempPath.getTarget().cycle > latest) {
+        latest = tempPath.getTarget().cycle;
+        t_path->swap(tempPath);
       }
       isAnyPredDFGNodeMapped = true;
     }
@@ -395,47 +479,43 @@ map<CGRANode*, int>* Mapper::calculateCost(CGRA* t_cgra, DFG* t_dfg,
   // TODO: should also consider the current config mem iterms.
   if (!isAnyPredDFGNodeMapped) {
     if (!t_fu->canSupport(t_dfgNode))
-      return NULL;
+      return false;
     int cycle = 0;
     while (cycle < m_maxMappingCycle) {
       if (t_fu->canOccupy(t_dfgNode, cycle, t_II)) {
-        path = new map<CGRANode*, int>();
-        (*path)[t_fu] = cycle;
+        t_path->addHop(t_fu, cycle);
         //cout<<"DEBUG how dare to map DFG node: "<<t_dfgNode->getID()<<"; CGRA node: "<<t_fu->getID()<<" at cycle "<< cycle<<endl;
-        return path;
+        return true;
       }
       ++cycle;
     }
 //    cout << "DEBUG: failed in mapping the starting DFG node "<<t_dfg->getID(t_dfgNode)<<" on CGRA node "<<t_fu->getID()<<endl;
+    return false;
   }
 //  cout<<".....in calculate cost path"<<endl;
-//  for (map<CGRANode*, int>::iterator iter=path->begin();
-//        iter!=path->end(); ++iter) {
-//    cout<<"(tile:"<<(*iter).first->getID()<<", cycle:"<<(*iter).second<<") --";
+//  for (int i=0; i<t_path->size(); ++i) {
+//    cout<<"(tile:"<<t_path->getHop(i).tile->getID()<<", cycle:"<<t_path->getHop(i).cycle<<") --";
 //  }
 //  cout<<endl;
-  return path;
+  return true;
 }
 
 // Schedule is based on the modulo II, the 'path' contains one
 // predecessor that can be definitely mapped, but the pathes
 // containing other predecessors have possibility to fail in mapping.
+// If 't_unrouted' is given, the failed routes are deferred into it.
 bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
-    DFGNode* t_dfgNode, map<CGRANode*, int>* t_path, bool t_isStaticElasticCGRA) {
-
-  map<int, CGRANode*>* reorderPath = getReorderPath(t_path);
-//
-//  // Since cycle on path increases gradually, re-order will not miss anything.
-//  for (map<CGRANode*, int>::iterator iter=t_path->begin(); iter!=t_path->end(); ++iter)
-//    reorderPath[(*iter).second] = (*iter).first;
-//  assert(reorderPath.size() == t_path->size());
+    DFGNode* t_dfgNode, MappingPath* t_path, bool t_isStaticElasticCGRA,
+    vector<Route>* t_unrouted) {
+  ScopedTimer timer(STATS_SCHEDULE);
 
-  map<int, CGRANode*>::reverse_iterator ri = reorderPath->rbegin();
-  CGRANode* fu = (*ri).second;
-  cout<<"[DEBUG] schedule dfg node["<<t_dfg->getID(t_dfgNode)<<"] onto fu["<<fu->getID()<<"] at cycle "<<(*t_path)[fu]<<" within II: "<<t_II<<endl;
+  // The hops on the path are already ordered by their cycles.
+  CGRANode* fu = t_path->getTarget().tile;
+  int fuCycle = t_path->getTarget().cycle;
+  LOG(LOG_LEVEL_TRACE)<<"[DEBUG] schedule dfg node["<<t_dfg->getID(t_dfgNode)<<"] onto fu["<<fu->getID()<<"] at cycle "<<fuCycle<<" within II: "<<t_II<<"\n";
 
   // Map the DFG node onto the CGRA nodes across cycles.
-  m_mapping[t_dfgNode] = fu;
+  setMapping(t_dfgNode, fu);
 
   // FIXME: Checks DVFS-related stuff around the canOccupy(). 1. Make sure the same island has
   // the same DVFS level. 2. The level matches the targeting DFG node. 3. Or no DFG node in the
@@ -445,51 +525,41 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
   if (fu->isDVFSEnabled()) {
     // assert(t_dfgNode->getDVFSLatencyMultiple() == fu->getDVFSLatencyMultiple());
   }
-  fu->setDFGNode(t_dfgNode, (*t_path)[fu], t_II, t_isStaticElasticCGRA);
+  fu->setDFGNode(t_dfgNode, fuCycle, t_II, t_isStaticElasticCGRA);
 
   // FIXME: Handles DVFS-related stuff here.
   t_cgra->syncDVFSIsland(fu);
 
-  m_mappingTiming[t_dfgNode] = (*t_path)[fu];
+  m_mappingTiming[t_dfgNode] = fuCycle;
 
   // Route the dataflow onto the CGRA links across cycles.
-  CGRANode* onePredCGRANode;
-  int onePredCGRANodeTiming;
-  map<int, CGRANode*>::iterator previousIter;
-  map<int, CGRANode*>::iterator next;
-  if (reorderPath->size() > 0) {
-    next = reorderPath->begin();
-    if (next != reorderPath->end())
-      ++next;
-  }
-  map<int, CGRANode*>::reverse_iterator riter=reorderPath->rbegin();
+  CGRANode* onePredCGRANode = t_path->getSource().tile;
+  int onePredCGRANodeTiming = t_path->getSource().cycle;
   bool generatedOut = true;
-  for (map<int, CGRANode*>::iterator iter=reorderPath->begin();
-      iter!=reorderPath->end(); ++iter) {
-    if (iter != reorderPath->begin()) {
-      CGRANode* srcCGRANode = (*(reorderPath->begin())).second;
-      int srcCycle = (*(reorderPath->begin())).first;
-      CGRALink* l = t_cgra->getLink((*previousIter).second, (*iter).second);
-
-      // Distinguish the bypassed and utilized data delivery on xbar.
-      bool isBypass = false;
-      int duration = (t_II+((*iter).first-(*previousIter).first)%t_II)%t_II;
-      if ((*riter).second != (*iter).second and
-          (*previousIter).first+1 == (*iter).first)
-        isBypass = true;
-      else
-        duration = (m_mappingTiming[t_dfgNode]-(*previousIter).first)%t_II;
-      l->occupy(srcCGRANode->getMappedDFGNode(srcCycle),
-                (*previousIter).first, duration,
-                t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
-      generatedOut = false;
-    } else {
-      onePredCGRANode = (*iter).second;
-      onePredCGRANodeTiming = (*iter).first;
-    }
-    previousIter = iter;
+  m_newRoutes.clear();
+  Route* route = NULL;
+  if (t_path->size() > 1)
+    route = addRoute(onePredCGRANode->getMappedDFGNode(onePredCGRANodeTiming),
+                     t_dfgNode);
+  for (int i=1; i<t_path->size(); ++i) {
+    const PathHop& previous = t_path->getHop(i-1);
+    const PathHop& current = t_path->getHop(i);
+    CGRALink* l = t_cgra->getLink(previous.tile, current.tile);
+
+    // Distinguish the bypassed and utilized data delivery on xbar.
+    bool isBypass = false;
+    int duration = (t_II+(current.cycle-previous.cycle)%t_II)%t_II;
+    if (fu != current.tile and previous.cycle+1 == current.cycle)
+      isBypass = true;
+    else
+      duration = (m_mappingTiming[t_dfgNode]-previous.cycle)%t_II;
+    l->occupy(route->src, previous.cycle, duration,
+              t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
+    route->reservations.push_back(
+        {l, NULL, previous.cycle, duration, isBypass, generatedOut});
+    ++m_routingCost;
+    generatedOut = false;
   }
-  delete reorderPath;
 
   // Try to route the path with other predecessors.
   // TODO: should consider the timing for static CGRA (two branches should
@@ -498,13 +568,17 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
     if (m_mapping.find(node) != m_mapping.end()) {
       if (m_mapping[(node)] == onePredCGRANode and
           onePredCGRANode->getMappedDFGNode(onePredCGRANodeTiming)==node) {
-        cout<<"[DEBUG] skip predecessor routing -- dfgNode: "<<node->getID()<<"\n";
+        LOG(LOG_LEVEL_TRACE)<<"[DEBUG] skip predecessor routing -- dfgNode: "<<node->getID()<<"\n";
         continue;
       }
 //      if (m_mapping[(node)] != onePredCGRANode) {
-      if (!tryToRoute(t_cgra, t_dfg, t_II, node, m_mapping[node], t_dfgNode, fu,
-          m_mappingTiming[t_dfgNode], false, t_isStaticElasticCGRA)){
-        cout<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped pred DFG node: "<<node->getID()<<"; return false\n";
+      // A predecessor placed after the DFG node is routed as if the DFG
+      // node were its successor placed before it.
+      bool bothNodesInCycle = !precedes(node, t_dfgNode) and
+                              isInSameCycle(t_dfgNode, node);
+      if (!routeOrDefer(t_cgra, t_dfg, t_II, node, t_dfgNode, bothNodesInCycle,
+          t_isStaticElasticCGRA, false, t_unrouted)) {
+        LOG(LOG_LEVEL_TRACE)<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped pred DFG node: "<<node->getID()<<"; return false\n";
         return false;
       }
 //    }
@@ -522,9 +596,11 @@ bool Mapper::schedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
 //          node->getCycleID() == t_dfgNode->getCycleID()) {
         bothNodesInCycle = true;
       }
-      if (!tryToRoute(t_cgra, t_dfg, t_II, t_dfgNode, fu, node, m_mapping[node],
-          m_mappingTiming[node], bothNodesInCycle, t_isStaticElasticCGRA)) {
-        cout<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped succ DFG node: "<<node->getID()<<"; return false\n";
+      // A successor placed after the DFG node (i.e., the DFG node is placed
+      // again) has to receive the data by its cycle.
+      if (!routeOrDefer(t_cgra, t_dfg, t_II, t_dfgNode, node, bothNodesInCycle,
+          t_isStaticElasticCGRA, precedes(t_dfgNode, node), t_unrouted)) {
+        LOG(LOG_LEVEL_TRACE)<<"DEBUG target DFG node: "<<t_dfgNode->getID()<<" on fu: "<<fu->getID()<<" failed, mapped succ DFG node: "<<node->getID()<<"; return false\n";
         return false;
       }
     }
@@ -681,8 +757,8 @@ void Mapper::showUtilization(CGRA* t_cgra, DFG* t_dfg, int t_II,
   avg_tile_xbar_utilization /= total_active_tiles;
   //max_tile_overall_utilization /= total_active_tiles;
 
-  cout << "tile avg fu utilization: " << avg_tile_fu_utilization*100 << "%; avg xbar utilization: " << avg_tile_xbar_utilization*100 << "%; avg overall utilization: " << avg_tile_overall_utilization*t_II*100 << "%" << endl;
-  cout << "max overall utilization: " << max_tile_overall_utilization*t_II*100 << "%" << endl;
+  LOG(LOG_LEVEL_INFO) << "tile avg fu utilization: " << avg_tile_fu_utilization*100 << "%; avg xbar utilization: " << avg_tile_xbar_utilization*100 << "%; avg overall utilization: " << avg_tile_overall_utilization*t_II*100 << "%\n";
+  LOG(LOG_LEVEL_INFO) << "max overall utilization: " << max_tile_overall_utilization*t_II*100 << "%\n";
 
   // Collects the histogram of tiles' utilization.
   // Histogram for the number of tiles that have utilization of 0%.
@@ -736,10 +812,10 @@ void Mapper::showUtilization(CGRA* t_cgra, DFG* t_dfg, int t_II,
     }
   }
 
-  std::cout << "histogram 0% tile utilization: " << tile_count_0 << endl;
-  std::cout << "histogram (0%, 25%] tile utilization: " << tile_count_0_to_25 << endl;
-  std::cout << "histogram (25%, 50%] tile utilization: " << tile_count_25_to_50 << endl;
-  std::cout << "histogram (50%, 100%] tile utilization: " << tile_count_50_to_100 << endl;
+  LOG(LOG_LEVEL_INFO) << "histogram 0% tile utilization: " << tile_count_0 << "\n";
+  LOG(LOG_LEVEL_INFO) << "histogram (0%, 25%] tile utilization: " << tile_count_0_to_25 << "\n";
+  LOG(LOG_LEVEL_INFO) << "histogram (25%, 50%] tile utilization: " << tile_count_25_to_50 << "\n";
+  LOG(LOG_LEVEL_INFO) << "histogram (50%, 100%] tile utilization: " << tile_count_50_to_100 << "\n";
 
   // std::cout << "histogram [0%, 25%] island utilization: " << island_count_0_to_25 << endl;
   // std::cout << "histogram (25%, 50%] island utilization: " << island_count_25_to_50 << endl;
@@ -803,20 +879,20 @@ void Mapper::showUtilization(CGRA* t_cgra, DFG* t_dfg, int t_II,
   float avg_tile_dvfs_ratio = 0.0;
   for (auto const& tile_ratio : tile_dvfs_ratio) {
     avg_tile_dvfs_ratio += tile_ratio.second;
-    cout << "tile " << tile_ratio.first << " DVFS frequency level: " << tile_ratio.second * 100 << "%" << endl;
+    LOG(LOG_LEVEL_INFO) << "tile " << tile_ratio.first << " DVFS frequency level: " << tile_ratio.second * 100 << "%\n";
   }
 
   if (avg_tile_dvfs_ratio == 0) {
     if (t_enablePowerGating) {
-      cout << "tile average DVFS frequency level: 0%" << endl;
+      LOG(LOG_LEVEL_INFO) << "tile average DVFS frequency level: 0%\n";
     } else {
       // Indicates DVFS mode is not enabled and no power gating.
       // Then, by default, the DVFS level is 100%.
-      cout << "tile average DVFS frequency level: 100%" << endl;
+      LOG(LOG_LEVEL_INFO) << "tile average DVFS frequency level: 100%\n";
     }
   } else {
     avg_tile_dvfs_ratio /= t_cgra->getFUCount();
-    cout << "tile average DVFS frequency level: " << avg_tile_dvfs_ratio * 100 << "%" << endl;
+    LOG(LOG_LEVEL_INFO) << "tile average DVFS frequency level: " << avg_tile_dvfs_ratio * 100 << "%\n";
   }
 
   // Collects the histogram of tiles' frequency ratio.
@@ -840,15 +916,15 @@ void Mapper::showUtilization(CGRA* t_cgra, DFG* t_dfg, int t_II,
     }
   }
 
-  std::cout << "histogram 0% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_0 << endl;
-  std::cout << "histogram 25% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_25 << endl;
-  std::cout << "histogram 50% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_50 << endl;
+  LOG(LOG_LEVEL_INFO) << "histogram 0% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_0 << "\n";
+  LOG(LOG_LEVEL_INFO) << "histogram 25% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_25 << "\n";
+  LOG(LOG_LEVEL_INFO) << "histogram 50% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_50 << "\n";
   if (avg_tile_dvfs_ratio == 0) {
     // Indicates DVFS mode is not enabled. Then, by default, the DVFS level is 100% for all the tiles.
     // I don't think this will be executed.
-    std::cout << "histogram 100% tile DVFS frequency ratio: " << t_cgra->getFUCount() << endl;
+    LOG(LOG_LEVEL_INFO) << "histogram 100% tile DVFS frequency ratio: " << t_cgra->getFUCount() << "\n";
   } else {
-    std::cout << "histogram 100% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_100 << endl;
+    LOG(LOG_LEVEL_INFO) << "histogram 100% tile DVFS frequency ratio: " << tile_count_dvfs_ratio_100 << "\n";
   }
 }
 
@@ -903,7 +979,7 @@ void Mapper::showSchedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
       }
     }
 
-    cout<<"--------------------------- cycle:"<<cycle<<" ---------------------------"<<endl;
+    LOG(LOG_LEVEL_INFO)<<"--------------------------- cycle:"<<cycle<<" ---------------------------\n";
     for (int i=0; i<t_cgra->getRows(); ++i) {
       for (int j=0; j<t_cgra->getColumns(); ++j) {
 
@@ -1005,12 +1081,12 @@ void Mapper::showSchedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
 //    for (int i=0; i<displayRows; ++i) {
     for (int i=displayRows-1; i>=0; --i) {
       for (int j=0; j<displayColumns; ++j) {
-        cout<<display[i][j];
+        LOG(LOG_LEVEL_INFO)<<display[i][j];
       }
     }
     ++cycle;
   }
-  cout<<"[Mapping II: "<<t_II<<"]"<<endl;
+  LOG(LOG_LEVEL_INFO)<<"[Mapping II: "<<t_II<<"]\n";
 
   if (t_parameterizableCGRA) {
     // TODO: make it clean
@@ -1024,24 +1100,50 @@ void Mapper::showSchedule(CGRA* t_cgra, DFG* t_dfg, int t_II,
 
 void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
     bool t_isStaticElasticCGRA) {
-  ofstream jsonFile;
-  jsonFile.open("config.json");
+  ScopedTimer timer(STATS_WRITE_JSON);
+  // The whole file is assembled in memory and written out at once.
+  ostringstream jsonFile;
   jsonFile<<"[\n";
+  int rows = t_cgra->getRows();
+  int columns = t_cgra->getColumns();
   if (!t_isStaticElasticCGRA) {
 
+    // Indexes the DFG node executed by each tile at each cycle and the DFG
+    // nodes bypassed through each link within one II up front, rather than
+    // scanning the DFG and the II slots for every tile at every cycle.
+    vector<vector<DFGNode*>> mappedDFGNodes(rows*columns,
+                                            vector<DFGNode*>(t_II+1, NULL));
+    for (int i=0; i<rows; ++i) {
+      for (int j=0; j<columns; ++j) {
+        CGRANode* cgraNode = t_cgra->nodes[i][j];
+        for (int t=0; t<t_II+1; ++t) {
+          DFGNode* dfgNode = cgraNode->getMappedDFGNode(t);
+          map<DFGNode*, CGRANode*>::iterator iter = m_mapping.find(dfgNode);
+          if (dfgNode != NULL and iter != m_mapping.end() and
+              iter->second == cgraNode) {
+            mappedDFGNodes[i*columns+j][t] = dfgNode;
+          }
+        }
+      }
+    }
+    vector<list<DFGNode*>> bypassedDFGNodes(t_cgra->getLinkCount());
+    for (int l=0; l<t_cgra->getLinkCount(); ++l) {
+      CGRALink* link = t_cgra->links[l];
+      for (int slot=0; slot<t_II; ++slot) {
+        if (link->isOccupied(slot, t_II, t_isStaticElasticCGRA) and
+            link->isBypass(slot)) {
+          bypassedDFGNodes[link->getID()].push_back(link->getMappedDFGNode(slot));
+        }
+      }
+    }
+
+    ConfigBinaryWriter binaryConfig;
     bool first = true;
     for (int t=0; t<t_II+1; ++t) {
-      for (int i=0; i<t_cgra->getRows(); ++i) {
-        for (int j=0; j<t_cgra->getColumns(); ++j) {
+      for (int i=0; i<rows; ++i) {
+        for (int j=0; j<columns; ++j) {
           CGRANode* currentCGRANode = t_cgra->nodes[i][j];
-          DFGNode* targetDFGNode = NULL;
-          for (DFGNode* dfgNode: t_dfg->nodes) {
-            if (m_mapping[dfgNode] == currentCGRANode and
-                currentCGRANode->getMappedDFGNode(t) == dfgNode) {
-              targetDFGNode = dfgNode;
-              break;
-            }
-          }
+          DFGNode* targetDFGNode = mappedDFGNodes[i*columns+j][t];
           list<CGRALink*>* inLinks = currentCGRANode->getInLinks();
           list<CGRALink*>* outLinks = currentCGRANode->getOutLinks();
           bool hasInform = false;
@@ -1075,6 +1177,7 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
           string targetOpt = "OPT_NAH";
           string stringDst[8];
           string predicate_in = "";
+          vector<int> predicatePorts;
           stringDst[0] = "none";
           stringDst[1] = "none";
           stringDst[2] = "none";
@@ -1096,6 +1199,7 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
                 predicate_in = "[";
               }
               predicate_in += to_string(il->getDirectionID(currentCGRANode));
+              predicatePorts.push_back(il->getDirectionID(currentCGRANode));
             }
           }
           // Handle predicate based on predecessor. Both the predecessor 'BR' and
@@ -1110,6 +1214,7 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
                 } else {
                   predicate_in += ",4";
                 }
+                predicatePorts.push_back(4);
                 break; // Assume only one predicatee at the same CGRA node.
               }
             }
@@ -1164,14 +1269,13 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
               // skip the outport as function unit inport, since they are
               // not regarded as bypass links.
               if (outIndex>=4) continue;
+              // The II cycles before next_t cover every slot of the link.
               for (CGRALink* il: *inLinks) {
-                for (int t_tmp=next_t-t_II; t_tmp<next_t; ++t_tmp) {
-                  if (il->isOccupied(t_tmp, t_II, t_isStaticElasticCGRA) and
-                      il->isBypass(t_tmp) and
-                      il->getMappedDFGNode(t_tmp) == ol->getMappedDFGNode(next_t)) {
-                    cout<<"[DEBUG] inside roi for CGRA node "<<currentCGRANode->getID()<<"...\n";
-                    if (il->getMappedDFGNode(t_tmp) == NULL)
-                      cout<<"[DEBUG] none..."<<il->getMappedDFGNode(t_tmp)<<"\n";
+                for (DFGNode* bypassedDFGNode: bypassedDFGNodes[il->getID()]) {
+                  if (bypassedDFGNode == ol->getMappedDFGNode(next_t)) {
+                    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] inside roi for CGRA node "<<currentCGRANode->getID()<<"...\n";
+                    if (bypassedDFGNode == NULL)
+                      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] none..."<<bypassedDFGNode<<"\n";
                     stringDst[outIndex] = to_string(il->getDirectionID(currentCGRANode));//+"; t_tmp: "+to_string(t_tmp)+"; dfg node: " + to_string(il->getMappedDFGNode(t_tmp)->getID());
                   }
                 }
@@ -1186,25 +1290,40 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
               jsonFile<<"\n";
           }
           jsonFile<<"  }";
+          if (m_binaryConfig) {
+            binaryConfig.addRecord(j, i, t, targetOpt, predicated,
+                                   predicatePorts, stringDst);
+          }
         }
       }
     }
     jsonFile<<"\n]\n";
-    jsonFile.close();
+    ofstream configFile("config.json");
+    configFile<<jsonFile.str();
+    if (m_binaryConfig and
+        !binaryConfig.write("config.bin", rows, columns, t_II)) {
+      LOG(LOG_LEVEL_ERROR)<<"Cannot write config.bin: "
+                          <<binaryConfig.getError()<<endl;
+    }
 
     return;
   }
   // TODO: should use nop/constant rather than none/self.
+  if (m_binaryConfig) {
+    LOG(LOG_LEVEL_INFO)<<"[config.bin is not supported by the static elastic CGRA]\n";
+  }
+  // The first DFG node (in the DFG order) mapped onto each tile.
+  map<CGRANode*, DFGNode*> tileDFGNodes;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    tileDFGNodes.insert(make_pair(m_mapping[dfgNode], dfgNode));
+  }
   bool first = true;
-  for (int i=0; i<t_cgra->getRows(); ++i) {
-    for (int j=0; j<t_cgra->getColumns(); ++j) {
+  for (int i=0; i<rows; ++i) {
+    for (int j=0; j<columns; ++j) {
       CGRANode* currentCGRANode = t_cgra->nodes[i][j];
       DFGNode* targetDFGNode = NULL;
-      for (DFGNode* dfgNode: t_dfg->nodes) {
-        if (m_mapping[dfgNode] == currentCGRANode) {
-          targetDFGNode = dfgNode;
-          break;
-        }
+      if (tileDFGNodes.find(currentCGRANode) != tileDFGNodes.end()) {
+        targetDFGNode = tileDFGNodes[currentCGRANode];
       }
       list<CGRALink*>* inLinks = currentCGRANode->getInLinks();
       list<CGRALink*>* outLinks = currentCGRANode->getOutLinks();
@@ -1349,7 +1468,29 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
     }
   }
   jsonFile<<"\n]\n";
-  jsonFile.close();
+  ofstream configFile("config.json");
+  configFile<<jsonFile.str();
+}
+
+// Searches the routes of the data the source DFG node produces on its
+// tile at the given cycle.
+void Mapper::searchRoutes(CGRA* t_cgra, int t_II, Router* t_router,
+    DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, int t_srcCycle,
+    CGRANode* t_dstCGRANode) {
+  t_router->init(t_srcDFGNode, t_srcCycle, m_maxMappingCycle);
+  // The source tile carries its own execution latency over to the tiles
+  // initialized after it in row-major order.
+  int srcLatency = t_srcDFGNode->getExecLatency(
+      t_srcCGRANode->getDVFSLatencyMultiple()) - 1;
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<t_cgra->getColumns(); ++j) {
+      CGRANode* node = t_cgra->nodes[i][j];
+      if (node->getID() > t_srcCGRANode->getID()) {
+        t_router->setTiming(node, t_router->getTiming(node) + srcLatency);
+      }
+    }
+  }
+  t_router->search(t_srcDFGNode, t_srcCGRANode, t_dstCGRANode, t_II);
 }
 
 // TODO: Assume that the arriving data can stay inside the input buffer.
@@ -1357,16 +1498,14 @@ void Mapper::generateJSON(CGRA* t_cgra, DFG* t_dfg, int t_II,
 // TODO: Should consider the unmapped predecessors.
 // TODO: Should consider the type of CGRA, say, a static in-elastic CGRA should
 //       join at the same successor at exact same cycle without pending.
+// The data has to arrive by 't_dstCycle' if 't_isDeadline' is set.
 bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
     DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode, DFGNode* t_dstDFGNode,
     CGRANode* t_dstCGRANode, int t_dstCycle, bool t_isBackedge,
-    bool t_isStaticElasticCGRA) {
-  cout<<"[DEBUG] tryToRoute -- srcDFGNode: "<<t_srcDFGNode->getID()<<", srcCGRANode: "<<t_srcCGRANode->getID()<<"; dstDFGNode: "<<t_dstDFGNode->getID()<<", dstCGRANode: "<<t_dstCGRANode->getID()<<"; backEdge: "<<t_isBackedge<<endl;
-  list<CGRANode*> searchPool;
-  map<CGRANode*, int> distance;
-  map<CGRANode*, int> timing;
-  map<CGRANode*, CGRANode*> previous;
-  timing[t_srcCGRANode] = m_mappingTiming[t_srcDFGNode];
+    bool t_isStaticElasticCGRA, bool t_isDeadline) {
+  ScopedTimer timer(STATS_TRY_TO_ROUTE);
+  LOG(LOG_LEVEL_TRACE)<<"[DEBUG] tryToRoute -- srcDFGNode: "<<t_srcDFGNode->getID()<<", srcCGRANode: "<<t_srcCGRANode->getID()<<"; dstDFGNode: "<<t_dstDFGNode->getID()<<", dstCGRANode: "<<t_dstCGRANode->getID()<<"; backEdge: "<<t_isBackedge<<"\n";
+  Router* router = getRouter();
   // Check whether the II is violated on each cycle.
   if (t_srcDFGNode->shareSameCycle(t_dstDFGNode)) {
     list<list<DFGNode*>*>* dfgNodeCycles = t_dfg->getCycleLists();
@@ -1394,141 +1533,82 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
         lastDFGNode = dfgNode;
       }
       if (totalTime > t_II) {
-        cout<<"[DEBUG] cannot route due to II is violated for backward cycle"<<endl;
+        LOG(LOG_LEVEL_TRACE)<<"[DEBUG] cannot route due to II is violated for backward cycle\n";
         return false;
       }
     }
   }
-  for (int i=0; i<t_cgra->getRows(); ++i) {
-    for (int j=0; j<t_cgra->getColumns(); ++j) {
-      CGRANode* node = t_cgra->nodes[i][j];
-      distance[node] = m_maxMappingCycle;
-      timing[node] = timing[t_srcCGRANode];
-      timing[node] += t_srcDFGNode->getExecLatency(node->getDVFSLatencyMultiple()) - 1;
-//      if (t_srcDFGNode->isLoad() or t_srcDFGNode->isStore()) {
-//        timing[node] += 1;
-//      }
-      previous[node] = NULL;
-      searchPool.push_back(t_cgra->nodes[i][j]);
-    }
-  }
-  distance[t_srcCGRANode] = 0;
-  while (searchPool.size()!=0) {
-    int minCost = m_maxMappingCycle + 1;
-    CGRANode* minNode;
-    for (CGRANode* currentNode: searchPool) {
-      if (distance[currentNode] < minCost) {
-        minCost = distance[currentNode];
-        minNode = currentNode;
-      }
-    }
-    searchPool.remove(minNode);
-    // found the target point in the shortest path
-    if (minNode == t_dstCGRANode) {
-      if (previous[minNode] == NULL)
-        break;
-    }
-    list<CGRANode*>* currentNeighbors = minNode->getNeighbors();
-
-    for (CGRANode* neighbor: *currentNeighbors) {
-      int cycle = timing[minNode];
-      while (1) {
-        CGRALink* currentLink = minNode->getOutLink(neighbor);
-        // TODO: should also consider the cost of the register file
-        if (currentLink->canOccupy(t_srcDFGNode, t_srcCGRANode, cycle, t_II)) {
-          // rough estimate the cost based on the suspend cycle
-          int cost = distance[minNode] + (cycle - timing[minNode]) + 1;
-          if (cost < distance[neighbor]) {
-            distance[neighbor] = cost;
-            timing[neighbor] = cycle + 1;
-            previous[neighbor] = minNode;
-          }
-          break;
-        }
-        ++cycle;
-        if(cycle > m_maxMappingCycle)
-          break;
-      }
-    }
-  }
+  searchRoutes(t_cgra, t_II, router, t_srcDFGNode, t_srcCGRANode,
+               m_mappingTiming[t_srcDFGNode], t_dstCGRANode);
 
   // Construct the shortest path for routing.
-  map<CGRANode*, int> path;
-  CGRANode* u = t_dstCGRANode;
-  if (previous[u] != NULL or u == t_srcCGRANode) {
-    while (u != NULL) {
-      path[u] = timing[u];
-      u = previous[u];
-    }
-  } else {
-    cout<<"[DEBUG] cannot route due to a path cannot be constructed"<<endl;
+  MappingPath path;
+  if (!router->buildPath(t_srcCGRANode, t_dstCGRANode, &path)) {
+    LOG(LOG_LEVEL_TRACE)<<"[DEBUG] cannot route due to a path cannot be constructed\n";
     return false;
   }
 
   // Not a valid mapping if it exceeds the 'm_maxMappingCycle'.
   // I don't think we need check II here.
-  if(timing[t_dstCGRANode] > m_maxMappingCycle) {
+  if(router->getTiming(t_dstCGRANode) > m_maxMappingCycle) {
     // timing[t_dstCGRANode] - timing[t_srcCGRANode] > t_II) {
     // cout<<"[DEBUG] cannot route due to II violation case 2: timing[CGRANode "<<t_dstCGRANode->getID()<<"] "<<timing[t_dstCGRANode]<<" - timing[CGRANode "<<t_srcCGRANode->getID()<<"] "<<timing[t_srcCGRANode]<<" > II "<<t_II<<endl;
     return false;
   }
+  if (t_isDeadline and router->getTiming(t_dstCGRANode) > t_dstCycle) {
+    LOG(LOG_LEVEL_TRACE)<<"[DEBUG] cannot route due to the data arrives after cycle "<<t_dstCycle<<"\n";
+    return false;
+  }
 
 
 //  if (timing[t_dstCGRANode]%t_II >= t_dstCycle%t_II)
   // Try to route the data flow.
-  map<int, CGRANode*>* reorderPath = getReorderPath(&path);
-//  //Since the cycle on path increases gradually, re-order will not miss anything.
-//  for(map<CGRANode*, int>::iterator iter=path.begin(); iter!=path.end(); ++iter) {
-//    reorderPath[(*iter).second] = (*iter).first;
-//  }
-//  assert(reorderPath.size() == path.size());
-
-  map<int, CGRANode*>::iterator previousIter;
-  map<int, CGRANode*>::reverse_iterator riter = reorderPath->rbegin();
-  cout<<"[DEBUG] check route size: "<<reorderPath->size()<<"\n";
-  if (reorderPath->size() == 1) {
-    int duration = (t_II+(t_dstCycle-(*riter).first)%t_II)%t_II;
-    cout<<"[DEBUG] allocate for local reg maintain... duration="<<duration<<" last cycle: "<<(*riter).first<<"\n";
-    (*riter).second->allocateReg(4, (*riter).first, duration, t_II);
+  PathHop& target = path.getTarget();
+  LOG(LOG_LEVEL_TRACE)<<"[DEBUG] check route size: "<<path.size()<<"\n";
+  Route* route = addRoute(t_srcDFGNode, t_dstDFGNode);
+  if (path.size() == 1) {
+    int duration = (t_II+(t_dstCycle-target.cycle)%t_II)%t_II;
+    LOG(LOG_LEVEL_TRACE)<<"[DEBUG] allocate for local reg maintain... duration="<<duration<<" last cycle: "<<target.cycle<<"\n";
+    target.tile->allocateReg(4, target.cycle, duration, t_II);
+    route->reservations.push_back(
+        {NULL, target.tile, target.cycle, duration, false, false});
   }
   bool generatedOut = true;
-  for (map<int, CGRANode*>::iterator iter = reorderPath->begin();
-      iter!=reorderPath->end(); ++iter) {
-    if (iter != reorderPath->begin()) {
-      CGRALink* l = t_cgra->getLink((*previousIter).second, (*iter).second);
-      bool isBypass = false;
-      int duration = ((*iter).first-(*previousIter).first)%t_II;
-      if ((*riter).second != (*iter).second and
-          (*previousIter).first+1 == (*iter).first)
-        isBypass = true;
-      else {
-        duration = (t_II+(t_dstCycle-(*previousIter).first)%t_II)%t_II;
-        cout<<"[DEBUG] reset duration: "<<duration<<" t_dstCycle: "<<t_dstCycle<<" previous: "<<(*previousIter).first<<" II: "<<t_II<<"\n";
-      }
-      if (duration == 0) {
-        cout<<"[DEBUG] reset duration is 0...\n";
-        // The successor can only be done within an interval of II, otherwise
-        // the II is no longer II but II*2.
-        if (t_isBackedge) {
-          cout<<"[DEBUG] cannot route due to backedge"<<endl;
-          return false;
-        }
-        duration = t_II;
+  for (int i=1; i<path.size(); ++i) {
+    const PathHop& previous = path.getHop(i-1);
+    const PathHop& current = path.getHop(i);
+    CGRALink* l = t_cgra->getLink(previous.tile, current.tile);
+    bool isBypass = false;
+    int duration = (current.cycle-previous.cycle)%t_II;
+    if (target.tile != current.tile and
+        previous.cycle+1 == current.cycle)
+      isBypass = true;
+    else {
+      duration = (t_II+(t_dstCycle-previous.cycle)%t_II)%t_II;
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] reset duration: "<<duration<<" t_dstCycle: "<<t_dstCycle<<" previous: "<<previous.cycle<<" II: "<<t_II<<"\n";
+    }
+    if (duration == 0) {
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] reset duration is 0...\n";
+      // The successor can only be done within an interval of II, otherwise
+      // the II is no longer II but II*2.
+      if (t_isBackedge) {
+        LOG(LOG_LEVEL_TRACE)<<"[DEBUG] cannot route due to backedge\n";
+        return false;
       }
-      l->occupy(t_srcDFGNode, (*previousIter).first,
-                duration, t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
-      generatedOut = false;
+      duration = t_II;
     }
-    previousIter = iter;
+    l->occupy(t_srcDFGNode, previous.cycle,
+              duration, t_II, isBypass, generatedOut, t_isStaticElasticCGRA);
+    route->reservations.push_back(
+        {l, NULL, previous.cycle, duration, isBypass, generatedOut});
+    ++m_routingCost;
+    generatedOut = false;
   }
 
-  map<int, CGRANode*>::iterator begin = reorderPath->begin();
-  map<int, CGRANode*>::reverse_iterator end = reorderPath->rbegin();
-
   // Check whether the backward data can be delivered within II.
   if (!t_isStaticElasticCGRA) {
-    if (t_isBackedge and (*end).first - (*begin).first >= t_II) {
-      cout<<"[DEBUG] cannot route due to backedge data cannot be delivered in time"<<endl;
+    if (t_isBackedge and target.cycle - path.getSource().cycle >= t_II) {
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] cannot route due to backedge data cannot be delivered in time\n";
       return false;
     }
   }
@@ -1537,66 +1617,17 @@ bool Mapper::tryToRoute(CGRA* t_cgra, DFG* t_dfg, int t_II,
 
 int Mapper::heuristicMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
     bool t_isStaticElasticCGRA) {
+  // The predecessors and successors are lazily collected, which must not
+  // happen concurrently.
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->getPredNodes();
+    dfgNode->getSuccNodes();
+  }
+  if (m_IISweepWidth > 1 and !t_isStaticElasticCGRA)
+    return parallelHeuristicMap(t_cgra, t_dfg, t_II);
   bool fail = false;
   while (1) {
-    cout<<"----------------------------------------\n";
-    cout<<"[DEBUG] start heuristic algorithm with II="<<t_II<<"\n";
-    int cycle = 0;
-    constructMRRG(t_dfg, t_cgra, t_II);
-    fail = false;
-    for (list<DFGNode*>::iterator dfgNode=t_dfg->nodes.begin();
-        dfgNode!=t_dfg->nodes.end(); ++dfgNode) {
-      
-      list<map<CGRANode*, int>*> paths;
-
-      #pragma omp parallel
-      {
-          list<map<CGRANode*, int>*> paths_private;
-          #pragma omp for collapse(2) nowait
-          for (int i=0; i<t_cgra->getRows(); ++i) {
-            for (int j=0; j<t_cgra->getColumns(); ++j) {
-              CGRANode* fu = t_cgra->nodes[i][j];
-              map<CGRANode*, int>* tempPath =
-                  calculateCost(t_cgra, t_dfg, t_II, *dfgNode, fu);
-              if(tempPath != NULL && tempPath->size() != 0) {
-                paths_private.push_back(tempPath);
-              }
-            }
-          }
-          #pragma omp critical
-          {
-              paths.splice(paths.end(), paths_private);
-          }
-      }
-      // Found some potential mappings.
-      if (paths.size() != 0) {
-        map<CGRANode*, int>* optimalPath =
-            getPathWithMinCostAndConstraints(t_cgra, t_dfg, t_II, *dfgNode, &paths);
-        if (optimalPath->size() != 0) {
-          if (!schedule(t_cgra, t_dfg, t_II, *dfgNode, optimalPath,
-              t_isStaticElasticCGRA)) {
-            cout<<"[DEBUG] fail1 in schedule() II: "<<t_II<<"\n";
-            for (map<CGRANode*,int>::iterator iter = optimalPath->begin();
-                iter!=optimalPath->end(); ++iter) {
-              cout<<"[DEBUG] the failed path -- cycle: "<<(*iter).second<<" CGRANode: "<<(*iter).first->getID()<<"\n";
-            }
-
-            fail = true;
-            break;
-          }
-          cout<<"[DEBUG] success in schedule()\n";
-        } else {
-          cout<<"[DEBUG] fail2 in schedule() II: "<<t_II<<"\n";
-          fail = true;
-          break;
-        }
-      } else {
-        fail = true;
-        cout<<"[DEBUG] *else* no available path for DFG node "<<(*dfgNode)->getID()
-            <<" within II "<<t_II<<".\n";
-        break;
-      }
-    }
+    fail = !heuristicMapWithII(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA);
     if (!fail)
       break;
     else if (t_isStaticElasticCGRA) {
@@ -1610,143 +1641,1414 @@ int Mapper::heuristicMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
     return -1;
 }
 
-int Mapper::exhaustiveMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
-    bool t_isStaticElasticCGRA) {
-  list<map<CGRANode*, int>*>* exhaustivePaths = new list<map<CGRANode*, int>*>();
-  list<DFGNode*>* mappedDFGNodes = new list<DFGNode*>();
-  bool success = DFSMap(t_cgra, t_dfg, t_II, mappedDFGNodes,
-      exhaustivePaths, t_isStaticElasticCGRA);
-  if (success)
-    return t_II;
-  else
-    return -1;
+// Maps the DFG with the given II. The attempt is given up once a lower
+// II has been successfully mapped by another concurrent attempt.
+bool Mapper::heuristicMapWithII(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA, atomic<int>* t_mappedII) {
+  LOG(LOG_LEVEL_DEBUG)<<"----------------------------------------\n";
+  LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] start heuristic algorithm with II="<<t_II<<"\n";
+  addStatsCount(STATS_II_ATTEMPTS, 1);
+  constructMRRG(t_dfg, t_cgra, t_II);
+  // The candidate path of each tile, which is reused for every DFG node.
+  vector<MappingPath> tilePaths(t_cgra->getFUCount());
+  // The schedules are journaled only if they might be repaired or routed
+  // again.
+  vector<Placement> placements;
+  if (m_repairAttempts > 0 or m_negotiatedRouting)
+    t_cgra->enableJournal();
+  bool success = true;
+  for (list<DFGNode*>::iterator dfgNode=t_dfg->nodes.begin();
+      dfgNode!=t_dfg->nodes.end(); ++dfgNode) {
+    if (t_mappedII != NULL and *t_mappedII < t_II) {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] cancel heuristic algorithm with II="<<t_II
+          <<" as II="<<*t_mappedII<<" is mapped\n";
+      success = false;
+      break;
+    }
+    if (!placeDFGNode(t_cgra, t_dfg, t_II, *dfgNode, &tilePaths,
+                      t_isStaticElasticCGRA, &placements) and
+        !negotiatePlacement(t_cgra, t_dfg, t_II, *dfgNode,
+                            t_isStaticElasticCGRA, &placements) and
+        !repairPlacement(t_cgra, t_dfg, t_II, *dfgNode, &tilePaths,
+                         t_isStaticElasticCGRA, &placements)) {
+      success = false;
+      break;
+    }
+  }
+  t_cgra->disableJournal();
+  return success;
 }
 
-bool Mapper::DFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
-    list<DFGNode*>* t_mappedDFGNodes,
-    list<map<CGRANode*, int>*>* t_exhaustivePaths,
+// Places the DFG node onto the cheapest candidate tile other than
+// 't_avoidTile' (if any). A failed schedule is undone if the placement
+// might be repaired.
+bool Mapper::placeDFGNode(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, vector<MappingPath>* t_tilePaths,
+    bool t_isStaticElasticCGRA, vector<Placement>* t_placements,
+    CGRANode* t_avoidTile) {
+  // Each tile is evaluated independently with read-only accesses to the
+  // MRRG and the mapping. The candidates are collected by tile so that
+  // their order does not depend on the thread scheduling.
+  int columns = t_cgra->getColumns();
+  bool anyPath = false;
+  #pragma omp parallel for collapse(2) reduction(||:anyPath)
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<columns; ++j) {
+      MappingPath* path = &(*t_tilePaths)[i*columns+j];
+      if (t_cgra->nodes[i][j] == t_avoidTile)
+        path->clear();
+      else if (calculateCost(t_cgra, t_dfg, t_II, t_dfgNode,
+                             t_cgra->nodes[i][j], path))
+        anyPath = true;
+    }
+  }
+  // Found some potential mappings.
+  if (anyPath) {
+    MappingPath* optimalPath =
+        getPathWithMinCostAndConstraints(t_cgra, t_dfg, t_II, t_dfgNode, t_tilePaths);
+    if (optimalPath != NULL) {
+      int mark = t_cgra->getJournalMark();
+      if (!schedule(t_cgra, t_dfg, t_II, t_dfgNode, optimalPath,
+          t_isStaticElasticCGRA)) {
+        LOG(LOG_LEVEL_TRACE)<<"[DEBUG] fail1 in schedule() II: "<<t_II<<"\n";
+        for (int i=0; i<optimalPath->size(); ++i) {
+          LOG(LOG_LEVEL_TRACE)<<"[DEBUG] the failed path -- cycle: "<<optimalPath->getHop(i).cycle<<" CGRANode: "<<optimalPath->getHop(i).tile->getID()<<"\n";
+        }
+        if (t_cgra->isJournalEnabled()) {
+          t_cgra->rollback(mark);
+          removeMapping(t_dfgNode);
+        }
+        return false;
+      }
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] success in schedule()\n";
+      addPlacement(t_cgra, t_dfgNode, mark, t_placements);
+      return true;
+    } else {
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] fail2 in schedule() II: "<<t_II<<"\n";
+      return false;
+    }
+  } else {
+    LOG(LOG_LEVEL_TRACE)<<"[DEBUG] *else* no available path for DFG node "<<t_dfgNode->getID()
+        <<" within II "<<t_II<<".\n";
+    return false;
+  }
+}
+
+// Places the DFG node back onto the given tile with the fresh routes.
+bool Mapper::placeDFGNodeOnTile(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, CGRANode* t_tile, bool t_isStaticElasticCGRA,
+    vector<Placement>* t_placements) {
+  MappingPath path;
+  if (!calculateCost(t_cgra, t_dfg, t_II, t_dfgNode, t_tile, &path))
+    return false;
+  int mark = t_cgra->getJournalMark();
+  if (!schedule(t_cgra, t_dfg, t_II, t_dfgNode, &path, t_isStaticElasticCGRA)) {
+    t_cgra->rollback(mark);
+    removeMapping(t_dfgNode);
+    return false;
+  }
+  addPlacement(t_cgra, t_dfgNode, mark, t_placements);
+  return true;
+}
+
+// Records the scheduled DFG node along with the routes made since the
+// given mark. Without DFG node, only the routes are recorded.
+void Mapper::addPlacement(CGRA* t_cgra, DFGNode* t_dfgNode, int t_mark,
+    vector<Placement>* t_placements) {
+  Placement placement = {t_dfgNode, NULL, 0, t_mark};
+  if (t_dfgNode != NULL) {
+    placement.tile = m_mapping[t_dfgNode];
+    placement.cycle = m_mappingTiming[t_dfgNode];
+  }
+  placement.routes.swap(m_newRoutes);
+  m_newRoutes.clear();
+  t_placements->push_back(move(placement));
+}
+
+// Starts recording the reservations of a new route.
+Route* Mapper::addRoute(DFGNode* t_srcDFGNode, DFGNode* t_dstDFGNode) {
+  m_newRoutes.push_back({t_srcDFGNode, t_dstDFGNode});
+  return &m_newRoutes.back();
+}
+
+// Makes the recorded reservations of the route again.
+void Mapper::restoreRoute(int t_II, Route* t_route,
     bool t_isStaticElasticCGRA) {
-//  , DFGNode* t_badMappedDFGNode) {
+  for (Reservation& reservation: t_route->reservations) {
+    if (reservation.link != NULL) {
+      reservation.link->occupy(t_route->src, reservation.cycle,
+          reservation.duration, t_II, reservation.isBypass,
+          reservation.isGeneratedOut, t_isStaticElasticCGRA);
+      ++m_routingCost;
+    } else {
+      reservation.tile->allocateReg(4, reservation.cycle,
+          reservation.duration, t_II);
+    }
+  }
+}
 
-//  list<map<CGRANode*, int>*>* exhaustivePaths = t_exhaustivePaths;
+// Routes the data of the source DFG node to the destination one. If the
+// routing fails and 't_unrouted' is given, the partial route is undone
+// and the edge is deferred into 't_unrouted' rather than failing.
+bool Mapper::routeOrDefer(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_srcDFGNode, DFGNode* t_dstDFGNode, bool t_isBackedge,
+    bool t_isStaticElasticCGRA, bool t_isDeadline, vector<Route>* t_unrouted) {
+  int mark = t_unrouted == NULL ? 0 : t_cgra->getJournalMark();
+  int routeCount = m_newRoutes.size();
+  if (tryToRoute(t_cgra, t_dfg, t_II, t_srcDFGNode, m_mapping[t_srcDFGNode],
+      t_dstDFGNode, m_mapping[t_dstDFGNode], m_mappingTiming[t_dstDFGNode],
+      t_isBackedge, t_isStaticElasticCGRA, t_isDeadline))
+    return true;
+  if (t_unrouted == NULL)
+    return false;
+  t_cgra->rollback(mark);
+  for (int i=routeCount; i<m_newRoutes.size(); ++i) {
+    for (Reservation& reservation: m_newRoutes[i].reservations) {
+      if (reservation.link != NULL)
+        --m_routingCost;
+    }
+  }
+  m_newRoutes.resize(routeCount);
+  t_unrouted->push_back({t_srcDFGNode, t_dstDFGNode});
+  return true;
+}
 
-  constructMRRG(t_dfg, t_cgra, t_II);
+// Repairs the failed placement of the DFG node rather than giving up the
+// II. Each attempt rips up a larger neighborhood around the DFG node,
+// i.e., its mapped predecessors and successors at first, and then also
+// the DFG nodes whose data occupies the links of the tiles in the
+// neighborhood. Only the ripped DFG nodes and their routes are
+// unscheduled. They are placed again in the mapping order, trying the
+// other tiles first to leave room for the failed one, and the failed one
+// is placed last. A failed attempt is undone before the next one.
+bool Mapper::repairPlacement(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, vector<MappingPath>* t_tilePaths,
+    bool t_isStaticElasticCGRA, vector<Placement>* t_placements) {
+  if (m_repairAttempts == 0)
+    return false;
+  set<DFGNode*> ripped;
+  set<DFGNode*> nets;
+  for (int attempt=1; attempt<=m_repairAttempts and
+       expandRepairNeighborhood(t_cgra, t_II, t_dfgNode, &ripped); ++attempt) {
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] repair attempt "<<attempt<<" of dfg node["<<t_dfgNode->getID()
+        <<"] rips up "<<ripped.size()<<" DFG nodes within II: "<<t_II<<"\n";
+    vector<Placement> unscheduled;
+    vector<Route> dropped;
+    unschedule(t_cgra, t_II, &ripped, &nets, t_isStaticElasticCGRA,
+               t_placements, &unscheduled, &dropped);
+    int first = t_placements->size();
+    bool repaired = true;
+    for (int i=0; repaired and i<unscheduled.size(); ++i) {
+      Placement& placement = unscheduled[i];
+      repaired = placeDFGNode(t_cgra, t_dfg, t_II, placement.dfgNode,
+                     t_tilePaths, t_isStaticElasticCGRA, t_placements,
+                     placement.tile) or
+                 placeDFGNode(t_cgra, t_dfg, t_II, placement.dfgNode,
+                     t_tilePaths, t_isStaticElasticCGRA, t_placements);
+    }
+    if (repaired and placeDFGNode(t_cgra, t_dfg, t_II, t_dfgNode, t_tilePaths,
+        t_isStaticElasticCGRA, t_placements)) {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] repair attempt "<<attempt<<" of dfg node["<<t_dfgNode->getID()
+          <<"] succeeds within II: "<<t_II<<"\n";
+      return true;
+    }
+    reschedule(t_cgra, t_II, first, t_isStaticElasticCGRA, &unscheduled,
+               &dropped, t_placements);
+  }
+  LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] fail to repair dfg node["<<t_dfgNode->getID()<<"] within II: "<<t_II<<"\n";
+  return false;
+}
 
-//  list<DFGNode*> dfgNodeSearchPool;
-//  for (list<DFGNode*>::iterator dfgNodeItr=dfg->nodes.begin();
-//      dfgNodeItr!=dfg->nodes.end(); ++dfgNodeItr) {
-//    dfgNodeSearchPool.push_back(*dfgNodeItr);
-//  }
+// Grows the neighborhood to be ripped up for the failed DFG node, which
+// fails if nothing more can be added.
+bool Mapper::expandRepairNeighborhood(CGRA* t_cgra, int t_II,
+    DFGNode* t_dfgNode, set<DFGNode*>* t_ripped) {
+  int size = t_ripped->size();
+  if (size == 0) {
+    for (DFGNode* node: *t_dfgNode->getPredNodes()) {
+      if (m_mapping.find(node) != m_mapping.end())
+        t_ripped->insert(node);
+    }
+    for (DFGNode* node: *t_dfgNode->getSuccNodes()) {
+      if (m_mapping.find(node) != m_mapping.end())
+        t_ripped->insert(node);
+    }
+    return t_ripped->size() != 0;
+  }
+  // The links around the ripped DFG nodes are the contested ones.
+  set<CGRANode*> tiles;
+  for (DFGNode* node: *t_ripped) {
+    tiles.insert(m_mapping[node]);
+  }
+  for (CGRANode* tile: tiles) {
+    list<CGRALink*> links(*tile->getInLinks());
+    links.insert(links.end(), tile->getOutLinks()->begin(),
+                 tile->getOutLinks()->end());
+    for (CGRALink* link: links) {
+      for (int cycle=0; cycle<t_II; ++cycle) {
+        DFGNode* node = link->getMappedDFGNode(cycle);
+        if (link->isOccupied(cycle) and node != NULL and node != t_dfgNode and
+            m_mapping.find(node) != m_mapping.end())
+          t_ripped->insert(node);
+      }
+    }
+  }
+  return t_ripped->size() > size;
+}
 
-  list<DFGNode*>::iterator mappedDFGNodeItr = t_mappedDFGNodes->begin();
-  list<DFGNode*>::iterator dfgNodeItr = t_dfg->nodes.begin();
-//  list<DFGNode*>::iterator dfgNodeItr = t_dfg->getDFSOrderedNodes()->begin();
-  for (map<CGRANode*, int>* path: *t_exhaustivePaths) {
-    if (!schedule(t_cgra, t_dfg, t_II, *mappedDFGNodeItr, path,
-        t_isStaticElasticCGRA)) {
-      cout<<"DEBUG <this is impossible> fail3 in DFS() II: "<<t_II<<"\n";
-      assert(0);
+// Unschedules the ripped DFG nodes along with their routes, and rips up
+// the nets of the given DFG nodes, i.e., all the routes delivering their
+// data, while the rest of the mapping stays as is. As the journal can
+// only be rolled back as a whole, everything since the earliest affected
+// placement is rolled back and then restored from the recorded
+// reservations without searching again. The unscheduled placements (in
+// the mapping order) and the other dropped routes are returned along
+// with the index of the earliest affected placement.
+int Mapper::unschedule(CGRA* t_cgra, int t_II, set<DFGNode*>* t_ripped,
+    set<DFGNode*>* t_nets, bool t_isStaticElasticCGRA,
+    vector<Placement>* t_placements, vector<Placement>* t_unscheduled,
+    vector<Route>* t_dropped) {
+  auto isDropped = [&](Route& t_route) {
+    return t_ripped->count(t_route.src) or t_ripped->count(t_route.dst) or
+           t_nets->count(t_route.src);
+  };
+  int earliest = 0;
+  for (; earliest<t_placements->size(); ++earliest) {
+    Placement& placement = (*t_placements)[earliest];
+    bool affected = t_ripped->count(placement.dfgNode);
+    for (Route& route: placement.routes) {
+      affected = affected or isDropped(route);
+    }
+    if (affected)
       break;
+  }
+  if (earliest == t_placements->size())
+    return earliest;
+  t_cgra->rollback((*t_placements)[earliest].mark);
+  vector<Placement> placements(make_move_iterator(t_placements->begin()+earliest),
+                               make_move_iterator(t_placements->end()));
+  t_placements->resize(earliest);
+  for (Placement& placement: placements) {
+    for (Route& route: placement.routes) {
+      for (Reservation& reservation: route.reservations) {
+        if (reservation.link != NULL)
+          --m_routingCost;
+      }
     }
-    ++mappedDFGNodeItr;
-//    dfgNodeSearchPool.remove(*dfgNodeItr);
-    ++dfgNodeItr;
+    if (t_ripped->count(placement.dfgNode)) {
+      LOG(LOG_LEVEL_TRACE)<<"[DEBUG] unschedule dfg node["<<placement.dfgNode->getID()
+          <<"] from fu["<<placement.tile->getID()<<"] within II: "<<t_II<<"\n";
+      removeMapping(placement.dfgNode);
+      t_unscheduled->push_back(move(placement));
+      continue;
+    }
+    placement.mark = t_cgra->getJournalMark();
+    if (placement.dfgNode != NULL) {
+      placement.tile->setDFGNode(placement.dfgNode, placement.cycle, t_II,
+                                 t_isStaticElasticCGRA);
+      t_cgra->syncDVFSIsland(placement.tile);
+    }
+    vector<Route> kept;
+    for (Route& route: placement.routes) {
+      if (isDropped(route)) {
+        t_dropped->push_back(move(route));
+      } else {
+        restoreRoute(t_II, &route, t_isStaticElasticCGRA);
+        kept.push_back(move(route));
+      }
+    }
+    placement.routes.swap(kept);
+    if (placement.dfgNode != NULL or placement.routes.size() != 0)
+      t_placements->push_back(move(placement));
   }
-//  if (dfgNodeSearchPool.size() == 0) {
-  if (dfgNodeItr == t_dfg->nodes.end())
-    return true;
-//  }
+  return earliest;
+}
+
+// Undoes the placements since 't_first' and schedules the unscheduled
+// placements (with or without DFG node) and the dropped routes again as
+// they were recorded.
+void Mapper::reschedule(CGRA* t_cgra, int t_II, int t_first,
+    bool t_isStaticElasticCGRA, vector<Placement>* t_unscheduled,
+    vector<Route>* t_dropped, vector<Placement>* t_placements) {
+  if (t_first < t_placements->size()) {
+    t_cgra->rollback((*t_placements)[t_first].mark);
+    for (int i=t_first; i<t_placements->size(); ++i) {
+      Placement& placement = (*t_placements)[i];
+      if (placement.dfgNode != NULL)
+        removeMapping(placement.dfgNode);
+      for (Route& route: placement.routes) {
+        for (Reservation& reservation: route.reservations) {
+          if (reservation.link != NULL)
+            --m_routingCost;
+        }
+      }
+    }
+    t_placements->resize(t_first);
+  }
+  // The routes of a placement only reach the DFG nodes placed before it.
+  for (Placement& placement: *t_unscheduled) {
+    placement.mark = t_cgra->getJournalMark();
+    if (placement.dfgNode != NULL) {
+      setMapping(placement.dfgNode, placement.tile);
+      m_mappingTiming[placement.dfgNode] = placement.cycle;
+      placement.tile->setDFGNode(placement.dfgNode, placement.cycle, t_II,
+                                 t_isStaticElasticCGRA);
+      t_cgra->syncDVFSIsland(placement.tile);
+    }
+    for (Route& route: placement.routes) {
+      restoreRoute(t_II, &route, t_isStaticElasticCGRA);
+    }
+    t_placements->push_back(move(placement));
+  }
+  t_unscheduled->clear();
+  if (t_dropped->size() != 0) {
+    Placement placement = {NULL, NULL, 0, t_cgra->getJournalMark()};
+    placement.routes.swap(*t_dropped);
+    for (Route& route: placement.routes) {
+      restoreRoute(t_II, &route, t_isStaticElasticCGRA);
+    }
+    t_placements->push_back(move(placement));
+  }
+}
 
-  DFGNode* targetDFGNode = *dfgNodeItr;
+void Mapper::setRepairAttempts(int t_repairAttempts) {
+  m_repairAttempts = t_repairAttempts;
+}
+
+void Mapper::setRefinementTimeLimit(long t_refinementTimeLimit) {
+  m_refinementTimeLimit = t_refinementTimeLimit;
+}
 
-  list<map<CGRANode*, int>*> paths;
+void Mapper::setBinaryConfig(bool t_binaryConfig) {
+  m_binaryConfig = t_binaryConfig;
+}
+
+// The objective of the refinement, i.e., the occupied slots of the links
+// and the registers, plus II for each DVFS island that is not idle (i.e.,
+// any of its tiles executes or delivers some data).
+int Mapper::getMappingCost(CGRA* t_cgra, int t_II) {
+  int cost = 0;
+  for (int i=0; i<t_cgra->getLinkCount(); ++i) {
+    cost += t_cgra->links[i]->getOccupiedSlotCount();
+  }
   for (int i=0; i<t_cgra->getRows(); ++i) {
     for (int j=0; j<t_cgra->getColumns(); ++j) {
-      CGRANode* fu = t_cgra->nodes[i][j];
-      map<CGRANode*, int>* tempPath =
-          calculateCost(t_cgra, t_dfg, t_II, targetDFGNode, fu);
-      if(tempPath != NULL and tempPath->size() != 0) {
-        paths.push_back(tempPath);
+      cost += t_cgra->nodes[i][j]->getOccupiedRegisterCount();
+    }
+  }
+  for (auto const& island: t_cgra->getDVFSIslands()) {
+    bool idle = true;
+    for (CGRANode* tile: island.second) {
+      if (getMappedDFGNodes(tile)->size() != 0)
+        idle = false;
+      for (CGRALink* link: *tile->getInLinks()) {
+        if (link->getOccupiedSlotCount() != 0)
+          idle = false;
+      }
+    }
+    if (!idle)
+      cost += t_II;
+  }
+  return cost;
+}
+
+// Places the DFG nodes from 't_first' on in order onto the given tiles,
+// which keeps the predecessors ahead of their successors.
+bool Mapper::placeOnTiles(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    vector<DFGNode*>* t_dfgNodes, vector<CGRANode*>* t_tiles, int t_first,
+    bool t_isStaticElasticCGRA, vector<Placement>* t_placements) {
+  for (int i=t_first; i<t_dfgNodes->size(); ++i) {
+    if (!placeDFGNodeOnTile(t_cgra, t_dfg, t_II, (*t_dfgNodes)[i],
+        (*t_tiles)[i], t_isStaticElasticCGRA, t_placements))
+      return false;
+  }
+  return true;
+}
+
+// Adds the tiles and the links the placement (or only its routes if the
+// tile is NULL) involves.
+static void addTouched(CGRANode* t_tile, vector<Route>* t_routes,
+    set<CGRALink*>* t_links, set<CGRANode*>* t_tiles) {
+  if (t_tile != NULL)
+    t_tiles->insert(t_tile);
+  for (Route& route: *t_routes) {
+    for (Reservation& reservation: route.reservations) {
+      // The data arriving through a link is held by the registers of its
+      // destination tile.
+      if (reservation.link != NULL) {
+        t_links->insert(reservation.link);
+        t_tiles->insert(reservation.link->getDst());
+      } else {
+        t_tiles->insert(reservation.tile);
+      }
+    }
+  }
+}
+
+// Recounts the cost (see getMappingCost()) of the given links and tiles
+// and of the DVFS islands they belong to. The previous counts are kept
+// in 't_counts', indexed by the links, then the tiles and then the
+// islands, and the replaced ones are appended to 't_replaced' so that
+// they can be put back. Returns the change of the cost.
+int Mapper::recountMappingCost(CGRA* t_cgra, int t_II,
+    set<CGRALink*>* t_links, set<CGRANode*>* t_tiles, vector<int>* t_counts,
+    vector<pair<int, int>>* t_replaced) {
+  int delta = 0;
+  auto replace = [&](int t_index, int t_count) {
+    if ((*t_counts)[t_index] == t_count)
+      return;
+    t_replaced->push_back(make_pair(t_index, (*t_counts)[t_index]));
+    delta += t_count - (*t_counts)[t_index];
+    (*t_counts)[t_index] = t_count;
+  };
+  int linkCount = t_cgra->getLinkCount();
+  int islandOffset = linkCount + t_cgra->getFUCount();
+  set<int> islands;
+  for (CGRALink* link: *t_links) {
+    replace(link->getID(), link->getOccupiedSlotCount());
+    islands.insert(link->getDst()->getDVFSIslandID());
+  }
+  for (CGRANode* tile: *t_tiles) {
+    replace(linkCount + tile->getID(), tile->getOccupiedRegisterCount());
+    islands.insert(tile->getDVFSIslandID());
+  }
+  map<int, vector<CGRANode*>> allIslands = t_cgra->getDVFSIslands();
+  for (int island: islands) {
+    bool idle = true;
+    for (CGRANode* tile: allIslands[island]) {
+      if (getMappedDFGNodes(tile)->size() != 0)
+        idle = false;
+      for (CGRALink* link: *tile->getInLinks()) {
+        if (link->getOccupiedSlotCount() != 0)
+          idle = false;
       }
     }
+    replace(islandOffset + island, idle ? 0 : t_II);
   }
+  return delta;
+}
 
-  list<map<CGRANode*, int>*>* potentialPaths =
-      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, targetDFGNode, &paths);
+// Simulated annealing over the placement of a successful mapping with the
+// II fixed. A move either relocates one DFG node onto another tile or
+// swaps the tiles of two DFG nodes. Only the moved DFG nodes and their
+// routes are unscheduled and placed again, and the running cost is
+// updated from the links and tiles they free and occupy. A rejected move
+// is undone by restoring the recorded placements and routes. A worse
+// move is accepted with the probability exp(-delta/T), where the
+// temperature starts at 5% of the initial cost and cools down linearly
+// within the time budget. The best mapping found is kept.
+void Mapper::refineMapping(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA, bool t_enablePowerGating) {
+  if (m_refinementTimeLimit <= 0)
+    return;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  int initialCost = getMappingCost(t_cgra, t_II);
+  LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] refinement starts with II="<<t_II<<"; cost: "<<initialCost<<"\n";
+  LOG(LOG_LEVEL_INFO)<<"[Utilization before refinement]\n";
+  showUtilization(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA, t_enablePowerGating);
+
+  // The best mapping is kept on a copy of the CGRA.
+  CGRA* bestCGRA = new CGRA(t_cgra);
+  Mapper* bestMapper = fork(bestCGRA, t_dfg);
+  int bestCost = initialCost;
+
+  // The mapping is placed again with the journal to record the placements.
+  vector<DFGNode*> dfgNodes(t_dfg->nodes.begin(), t_dfg->nodes.end());
+  vector<CGRANode*> tiles;
+  for (DFGNode* dfgNode: dfgNodes) {
+    tiles.push_back(m_mapping[dfgNode]);
+  }
+  vector<Placement> placements;
+  constructMRRG(t_dfg, t_cgra, t_II);
+  t_cgra->enableJournal();
+  bool consistent = placeOnTiles(t_cgra, t_dfg, t_II, &dfgNodes, &tiles, 0,
+                                 t_isStaticElasticCGRA, &placements);
+
+  // The running cost is counted once for all the links, tiles and islands.
+  int islandCount = 0;
+  for (auto const& island: t_cgra->getDVFSIslands()) {
+    islandCount = max(islandCount, island.first + 1);
+  }
+  vector<int> counts(t_cgra->getLinkCount() + t_cgra->getFUCount() +
+                     islandCount, 0);
+  set<CGRALink*> allLinks(t_cgra->links, t_cgra->links +
+                          t_cgra->getLinkCount());
+  set<CGRANode*> allTiles;
+  for (int i=0; i<t_cgra->getFUCount(); ++i) {
+    allTiles.insert(t_cgra->getNode(i));
+  }
+  vector<pair<int, int>> replaced;
+  int cost = recountMappingCost(t_cgra, t_II, &allLinks, &allTiles, &counts,
+                                &replaced);
+
+  mt19937 random(0);
+  uniform_real_distribution<float> probability(0, 1);
+  float initialTemperature = initialCost * 0.05;
+  int moves = 0;
+  int accepted = 0;
+  while (consistent) {
+    long elapsed = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - start).count();
+    if (elapsed >= m_refinementTimeLimit)
+      break;
+    float temperature = initialTemperature *
+        (1 - float(elapsed) / m_refinementTimeLimit);
+    ++moves;
+
+    // Either relocates or swaps with another DFG node.
+    DFGNode* first = dfgNodes[random() % dfgNodes.size()];
+    DFGNode* second = dfgNodes[random() % dfgNodes.size()];
+    CGRANode* firstTile = m_mapping[first];
+    CGRANode* secondTile = m_mapping[second];
+    if (random() % 2 == 0 and first != second) {
+      swap(firstTile, secondTile);
+    } else {
+      second = NULL;
+      firstTile = t_cgra->getNode(random() % t_cgra->getFUCount());
+    }
+    if (firstTile == m_mapping[first] and
+        (second == NULL or secondTile == m_mapping[second]))
+      continue;
+    set<DFGNode*> ripped = {first};
+    if (second != NULL)
+      ripped.insert(second);
+    set<DFGNode*> nets;
+    vector<Placement> unscheduled;
+    vector<Route> dropped;
+    unschedule(t_cgra, t_II, &ripped, &nets, t_isStaticElasticCGRA,
+               &placements, &unscheduled, &dropped);
+    int placed = placements.size();
+    bool valid = placeDFGNodeOnTile(t_cgra, t_dfg, t_II, first, firstTile,
+                                    t_isStaticElasticCGRA, &placements) and
+                 (second == NULL or placeDFGNodeOnTile(t_cgra, t_dfg, t_II,
+                      second, secondTile, t_isStaticElasticCGRA, &placements));
+    int delta = 0;
+    replaced.clear();
+    if (valid) {
+      set<CGRALink*> links;
+      set<CGRANode*> touched;
+      for (Placement& placement: unscheduled) {
+        addTouched(placement.tile, &placement.routes, &links, &touched);
+      }
+      addTouched(NULL, &dropped, &links, &touched);
+      for (int i=placed; i<placements.size(); ++i) {
+        addTouched(placements[i].tile, &placements[i].routes, &links,
+                   &touched);
+      }
+      delta = recountMappingCost(t_cgra, t_II, &links, &touched, &counts,
+                                 &replaced);
+    }
+    if (valid and (delta <= 0 or
+        probability(random) < exp(-delta / temperature))) {
+      ++accepted;
+      cost += delta;
+      if (cost < bestCost) {
+        delete bestMapper;
+        delete bestCGRA;
+        bestCGRA = new CGRA(t_cgra);
+        bestMapper = fork(bestCGRA, t_dfg);
+        bestCost = cost;
+      }
+      continue;
+    }
+
+    // Restores the mapping and the counts before the move.
+    reschedule(t_cgra, t_II, placed, t_isStaticElasticCGRA, &unscheduled,
+               &dropped, &placements);
+    for (int i=replaced.size()-1; i>=0; --i) {
+      counts[replaced[i].first] = replaced[i].second;
+    }
+  }
+  t_cgra->disableJournal();
+
+  // Falls back onto the best mapping, which is also needed if the mapping
+  // cannot be placed again (e.g., the routes depended on the congestion
+  // costs of the negotiated routing).
+  if (!consistent or cost > bestCost) {
+    t_cgra->copyMRRG(bestCGRA);
+    copyMapping(bestMapper, t_cgra, t_dfg);
+    cost = bestCost;
+  }
+  delete bestMapper;
+  delete bestCGRA;
+  LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] refinement ends after "<<moves<<" moves ("<<accepted
+      <<" accepted); cost: "<<initialCost<<" -> "<<cost<<"\n";
+}
+
+void Mapper::setCongestion(vector<float>* t_history, float t_presentFactor) {
+  for (Router* router: m_routers) {
+    router->setCongestion(t_history, t_presentFactor);
+  }
+}
+
+// PathFinder-style negotiation of the failed placement of the DFG node,
+// which is tried before the repair. The routers of the probes may overuse
+// the slots blocked by other data at the price of the present factor and
+// the history cost. The first iteration probes the tiles and takes the
+// cheapest one, the later ones probe the pending routes. Only the slots
+// the probed routes overuse are contested: their history cost grows, and
+// the nets blocking them are ripped up and become pending. Then the DFG
+// node is placed onto the tile and the pending routes are routed again,
+// both without any overuse but avoiding the slots with history, where
+// the failed routes stay pending for the next iteration, which raises
+// the present factor. The negotiation succeeds once nothing is pending,
+// and gives up (restoring the mapping) once the iterations run out or no
+// slot is contested anymore, e.g., the timing is the bottleneck.
+bool Mapper::negotiatePlacement(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    DFGNode* t_dfgNode, bool t_isStaticElasticCGRA,
+    vector<Placement>* t_placements) {
+  if (!m_negotiatedRouting)
+    return false;
+  if (m_linkHistory.size() == 0)
+    m_linkHistory.assign(t_cgra->getLinkCount()*t_II, 0);
+  // The placements since 'touched' are restored if the negotiation fails.
+  vector<Placement> saved(*t_placements);
+  int touched = t_placements->size();
+  vector<Route> pending;
+  CGRANode* tile = NULL;
+  int columns = t_cgra->getColumns();
+  float presentFactor = 0.5;
   bool success = false;
-  while (potentialPaths->size() != 0) {
-    map<CGRANode*, int>* currentPath = potentialPaths->front();
-    potentialPaths->pop_front();
-    assert(currentPath->size() != 0);
-    if (schedule(t_cgra, t_dfg, t_II, targetDFGNode, currentPath,
-        t_isStaticElasticCGRA)) {
-      t_exhaustivePaths->push_back(currentPath);
-      t_mappedDFGNodes->push_back(targetDFGNode);
-      success = DFSMap(t_cgra, t_dfg, t_II, t_mappedDFGNodes,
-          t_exhaustivePaths, t_isStaticElasticCGRA);
-      if (success)
-        return true;
+  for (int iteration=1; iteration<=m_negotiationIterations;
+       ++iteration, presentFactor*=1.5) {
+    setCongestion(&m_linkHistory, presentFactor);
+    set<pair<int, int>> contested;
+    set<DFGNode*> nets;
+    bool isPlaced = m_mapping.find(t_dfgNode) != m_mapping.end();
+    if (!isPlaced) {
+      vector<float> costs(t_cgra->getFUCount());
+      vector<set<pair<int, int>>> tileContested(t_cgra->getFUCount());
+      vector<set<DFGNode*>> tileNets(t_cgra->getFUCount());
+      #pragma omp parallel for collapse(2)
+      for (int i=0; i<t_cgra->getRows(); ++i) {
+        for (int j=0; j<columns; ++j) {
+          int id = i*columns+j;
+          costs[id] = probePlacement(t_cgra, t_II, t_dfgNode,
+              t_cgra->nodes[i][j], presentFactor, &tileContested[id],
+              &tileNets[id]);
+        }
+      }
+      int best = min_element(costs.begin(), costs.end()) - costs.begin();
+      if (costs[best] == FLT_MAX)
+        break;
+      tile = t_cgra->nodes[best/columns][best%columns];
+      contested.swap(tileContested[best]);
+      nets.swap(tileNets[best]);
+    }
+    bool isRoutable = true;
+    for (int i=0; isRoutable and i<pending.size(); ++i) {
+      DFGNode* src = pending[i].src;
+      DFGNode* dst = pending[i].dst;
+      int arrival;
+      isRoutable = probeRoute(t_cgra, t_II, src, m_mapping.at(src),
+          m_mappingTiming.at(src), m_mapping.at(dst), precedes(src, dst) ?
+          m_mappingTiming.at(dst) : -1, presentFactor, &arrival, &contested,
+          &nets) != FLT_MAX;
+    }
+    if (!isRoutable)
+      break;
+    for (const pair<int, int>& slot: contested) {
+      m_linkHistory[slot.first*t_II + slot.second] += 1;
+    }
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] negotiated routing iteration "<<iteration<<" of dfg node["
+        <<t_dfgNode->getID()<<"] onto fu["<<tile->getID()<<"] contests "<<contested.size()
+        <<" slots of "<<nets.size()<<" nets with "<<pending.size()
+        <<" pending routes; present factor: "<<presentFactor<<"\n";
+
+    setCongestion(&m_linkHistory, 0);
+    set<DFGNode*> ripped;
+    vector<Placement> unscheduled;
+    touched = min(touched, unschedule(t_cgra, t_II, &ripped, &nets,
+        t_isStaticElasticCGRA, t_placements, &unscheduled, &pending));
+    MappingPath path;
+    if (!isPlaced and
+        calculateCost(t_cgra, t_dfg, t_II, t_dfgNode, tile, &path)) {
+      int mark = t_cgra->getJournalMark();
+      schedule(t_cgra, t_dfg, t_II, t_dfgNode, &path, t_isStaticElasticCGRA,
+               &pending);
+      addPlacement(t_cgra, t_dfgNode, mark, t_placements);
+    }
+    routePending(t_cgra, t_dfg, t_II, &pending, t_isStaticElasticCGRA,
+                 t_placements);
+    if (m_mapping.find(t_dfgNode) != m_mapping.end() and pending.size() == 0) {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] negotiated routing iteration "<<iteration<<" of dfg node["
+          <<t_dfgNode->getID()<<"] succeeds within II: "<<t_II<<"\n";
+      success = true;
+      break;
+    }
+    // Nothing changes in the next iteration without any contested slot.
+    if (contested.size() == 0)
+      break;
+  }
+  if (!success) {
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] negotiated routing of dfg node["<<t_dfgNode->getID()
+        <<"] fails within II: "<<t_II<<"\n";
+    vector<Placement> restored(make_move_iterator(saved.begin()+touched),
+                               make_move_iterator(saved.end()));
+    vector<Route> dropped;
+    reschedule(t_cgra, t_II, touched, t_isStaticElasticCGRA, &restored,
+               &dropped, t_placements);
+  }
+  // The other placements are routed without congestion.
+  setCongestion(NULL, 0);
+  return success;
+}
+
+// The negotiated cost of placing the DFG node onto the tile, i.e., the
+// total cost of the probed routes from its mapped predecessors and to its
+// mapped successors. Their overused slots (i.e., the link IDs and the
+// modulo slots) are collected along with the DFG nodes whose nets block
+// them. FLT_MAX indicates the tile cannot host the DFG node at all.
+float Mapper::probePlacement(CGRA* t_cgra, int t_II, DFGNode* t_dfgNode,
+    CGRANode* t_tile, float t_presentFactor, set<pair<int, int>>* t_contested,
+    set<DFGNode*>* t_nets) {
+  if (!t_tile->canSupport(t_dfgNode))
+    return FLT_MAX;
+  float cost = 0;
+  int latest = -1;
+  for (DFGNode* pre: *t_dfgNode->getPredNodes()) {
+    if (m_mapping.find(pre) == m_mapping.end())
+      continue;
+    int arrival;
+    float routeCost = probeRoute(t_cgra, t_II, pre, m_mapping.at(pre),
+        m_mappingTiming.at(pre), t_tile, -1, t_presentFactor, &arrival,
+        t_contested, t_nets);
+    if (routeCost == FLT_MAX)
+      return FLT_MAX;
+    cost += routeCost;
+    // Only the predecessors placed before the DFG node time it.
+    if (precedes(pre, t_dfgNode))
+      latest = max(latest, arrival);
+  }
+  int cycle = t_tile->getMinIdleCycle(t_dfgNode, max(latest, 0), t_II);
+  if (cycle >= m_maxMappingCycle)
+    return FLT_MAX;
+  for (DFGNode* succ: *t_dfgNode->getSuccNodes()) {
+    if (m_mapping.find(succ) == m_mapping.end())
+      continue;
+    int arrival;
+    float routeCost = probeRoute(t_cgra, t_II, t_dfgNode, t_tile, cycle,
+        m_mapping.at(succ), precedes(t_dfgNode, succ) ?
+        m_mappingTiming.at(succ) : -1, t_presentFactor, &arrival,
+        t_contested, t_nets);
+    if (routeCost == FLT_MAX)
+      return FLT_MAX;
+    cost += routeCost;
+  }
+  return cost;
+}
+
+// Probes the route of the data the source DFG node produces on its tile
+// at the given cycle towards the destination tile by the deadline (-1 for
+// none). If the cheapest route is late, the earliest one is probed, for
+// which the overuse costs nothing. The slots the route overuses are
+// collected along with the DFG nodes whose data blocks them. Returns the
+// cost of the route, or FLT_MAX if it cannot be in time even with overuse.
+float Mapper::probeRoute(CGRA* t_cgra, int t_II, DFGNode* t_srcDFGNode,
+    CGRANode* t_srcCGRANode, int t_srcCycle, CGRANode* t_dstCGRANode,
+    int t_deadline, float t_presentFactor, int* t_arrival,
+    set<pair<int, int>>* t_contested, set<DFGNode*>* t_nets) {
+  Router* router = getRouter();
+  if (t_deadline == -1 or t_deadline > m_maxMappingCycle)
+    t_deadline = m_maxMappingCycle;
+  MappingPath path;
+  searchRoutes(t_cgra, t_II, router, t_srcDFGNode, t_srcCGRANode, t_srcCycle,
+               t_dstCGRANode);
+  bool isRouted = router->buildPath(t_srcCGRANode, t_dstCGRANode, &path);
+  if (!isRouted or router->getTiming(t_dstCGRANode) > t_deadline) {
+    router->setCongestion(NULL, FLT_MIN);
+    searchRoutes(t_cgra, t_II, router, t_srcDFGNode, t_srcCGRANode,
+                 t_srcCycle, t_dstCGRANode);
+    isRouted = router->buildPath(t_srcCGRANode, t_dstCGRANode, &path) and
+               router->getTiming(t_dstCGRANode) <= t_deadline;
+    router->setCongestion(&m_linkHistory, t_presentFactor);
+  }
+  if (!isRouted)
+    return FLT_MAX;
+  *t_arrival = router->getTiming(t_dstCGRANode);
+  addContestedSlots(t_cgra, t_II, t_srcDFGNode, t_srcCGRANode, &path,
+                    t_contested, t_nets);
+  return router->getDistance(t_dstCGRANode);
+}
+
+// Collects the slots overused by the probed route of the source DFG node
+// along with the DFG nodes whose data blocks them.
+void Mapper::addContestedSlots(CGRA* t_cgra, int t_II, DFGNode* t_srcDFGNode,
+    CGRANode* t_srcCGRANode, MappingPath* t_path,
+    set<pair<int, int>>* t_contested, set<DFGNode*>* t_nets) {
+  vector<DFGNode*> blockers;
+  for (int i=1; i<t_path->size(); ++i) {
+    CGRALink* link = t_cgra->getLink(t_path->getHop(i-1).tile,
+                                     t_path->getHop(i).tile);
+    int cycle = t_path->getHop(i).cycle - 1;
+    if (link->canOccupy(t_srcDFGNode, t_srcCGRANode, cycle, t_II))
+      continue;
+    blockers.clear();
+    link->getBlockingDFGNodes(t_srcDFGNode, t_srcCGRANode, cycle, t_II,
+                              &blockers);
+    t_contested->insert(make_pair(link->getID(), (cycle%t_II + t_II) % t_II));
+    t_nets->insert(blockers.begin(), blockers.end());
+  }
+}
+
+// Routes the pending edges again, as a placement that only carries routes.
+// A route towards a DFG node placed later in the mapping order has to
+// deliver the data by its cycle, while the others reach the next
+// iterations. The failed ones stay pending.
+void Mapper::routePending(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    vector<Route>* t_pending, bool t_isStaticElasticCGRA,
+    vector<Placement>* t_placements) {
+  int mark = t_cgra->getJournalMark();
+  m_newRoutes.clear();
+  vector<Route> unrouted;
+  for (Route& route: *t_pending) {
+    bool isForward = precedes(route.src, route.dst);
+    routeOrDefer(t_cgra, t_dfg, t_II, route.src, route.dst,
+                 !isForward and isInSameCycle(route.src, route.dst),
+                 t_isStaticElasticCGRA, isForward, &unrouted);
+  }
+  t_pending->swap(unrouted);
+  if (m_newRoutes.size() != 0)
+    addPlacement(t_cgra, NULL, mark, t_placements);
+}
+
+void Mapper::setNegotiatedRouting(bool t_negotiatedRouting,
+    int t_negotiationIterations) {
+  m_negotiatedRouting = t_negotiatedRouting;
+  m_negotiationIterations = t_negotiationIterations;
+}
+
+// Sweeps 'm_IISweepWidth' consecutive IIs at a time, each of which is
+// mapped by its own mapper onto its own clone of the CGRA. The lowest
+// mapped II wins, and its mapping is taken over by this mapper and the
+// given CGRA. The candidate tiles of each attempt are then evaluated
+// sequentially unless nested parallelism is enabled.
+int Mapper::parallelHeuristicMap(CGRA* t_cgra, DFG* t_dfg, int t_II) {
+  while (1) {
+    LOG(LOG_LEVEL_DEBUG)<<"----------------------------------------\n";
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] start parallel heuristic algorithm with II="<<t_II
+        <<" to "<<t_II+m_IISweepWidth-1<<"\n";
+    atomic<int> mappedII(INT_MAX);
+    vector<CGRA*> cgras(m_IISweepWidth, NULL);
+    vector<Mapper*> mappers(m_IISweepWidth, NULL);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i=0; i<m_IISweepWidth; ++i) {
+      int II = t_II + i;
+      cgras[i] = new CGRA(t_cgra);
+      mappers[i] = new Mapper(m_DVFSAwareMapping);
+      mappers[i]->setNegotiatedRouting(m_negotiatedRouting,
+                                       m_negotiationIterations);
+      mappers[i]->setRepairAttempts(m_repairAttempts);
+      bool mapped = mappers[i]->heuristicMapWithII(cgras[i], t_dfg, II, false,
+                                                   &mappedII);
+      if (mapped) {
+        int current = mappedII;
+        while (II < current and
+               !mappedII.compare_exchange_weak(current, II));
+      }
+    }
+    int II = mappedII;
+    if (II != INT_MAX) {
+      int i = II - t_II;
+      t_cgra->copyMRRG(cgras[i]);
+      copyMapping(mappers[i], t_cgra, t_dfg);
+    }
+    for (int i=0; i<m_IISweepWidth; ++i) {
+      delete mappers[i];
+      delete cgras[i];
+    }
+    if (II != INT_MAX) {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] parallel heuristic algorithm succeeds with II="<<II<<"\n";
+      return II;
+    }
+    t_II += m_IISweepWidth;
+  }
+}
+
+// Takes over the mapping found by another mapper on a clone of the CGRA.
+void Mapper::copyMapping(Mapper* t_mapper, CGRA* t_cgra, DFG* t_dfg) {
+  clearMapping(t_cgra);
+  m_maxMappingCycle = t_mapper->m_maxMappingCycle;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->clearMapped();
+    if (t_mapper->m_mapping.find(dfgNode) != t_mapper->m_mapping.end()) {
+      setMapping(dfgNode, t_cgra->getNode(t_mapper->m_mapping[dfgNode]->getID()));
+      m_mappingTiming[dfgNode] = t_mapper->m_mappingTiming[dfgNode];
+      dfgNode->setMapped();
+    }
+  }
+  m_routingCost = t_mapper->m_routingCost;
+}
+
+// Places each DFG node in order onto the given tile, where it must be
+// reached at the given cycle, which validates a cached mapping against the
+// MRRG while routing it again.
+bool Mapper::replayMapping(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    vector<int>* t_tiles, vector<int>* t_cycles, bool t_isStaticElasticCGRA) {
+  if (t_tiles->size() != t_dfg->nodes.size() or
+      t_cycles->size() != t_dfg->nodes.size())
+    return false;
+  constructMRRG(t_dfg, t_cgra, t_II);
+  int i = 0;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    int tileID = (*t_tiles)[i];
+    int cycle = (*t_cycles)[i];
+    ++i;
+    MappingPath path;
+    if (tileID < 0 or tileID >= t_cgra->getFUCount() or
+        !calculateCost(t_cgra, t_dfg, t_II, dfgNode, t_cgra->getNode(tileID),
+                       &path) or
+        path.getTarget().cycle != cycle or
+        !schedule(t_cgra, t_dfg, t_II, dfgNode, &path, t_isStaticElasticCGRA)) {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] cannot replay DFG node "<<dfgNode->getID()<<" onto tile "
+          <<tileID<<" at cycle "<<cycle<<" within II: "<<t_II<<"\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Maps the DFG by replaying its cached mapping. Returns the II, or -1 if
+// there is no cached mapping or it is no longer valid.
+int Mapper::cachedMap(CGRA* t_cgra, DFG* t_dfg, MappingCache* t_cache,
+    bool t_isStaticElasticCGRA) {
+  int II;
+  vector<int> tiles;
+  vector<int> cycles;
+  if (!t_cache->load(&II, &tiles, &cycles))
+    return -1;
+  LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] replay cached mapping "<<t_cache->getKey()<<" with II="<<II<<"\n";
+  if (!replayMapping(t_cgra, t_dfg, II, &tiles, &cycles, t_isStaticElasticCGRA))
+    return -1;
+  return II;
+}
+
+// Whether the links of both CGRAs carry the same data in every modulo slot.
+static bool isSameRouting(CGRA* t_a, CGRA* t_b, int t_II) {
+  for (int i=0; i<t_a->getLinkCount(); ++i) {
+    for (int cycle=0; cycle<t_II; ++cycle) {
+      if (t_a->links[i]->isOccupied(cycle) != t_b->links[i]->isOccupied(cycle) or
+          t_a->links[i]->isBypass(cycle) != t_b->links[i]->isBypass(cycle) or
+          t_a->links[i]->getMappedDFGNode(cycle) !=
+          t_b->links[i]->getMappedDFGNode(cycle))
+        return false;
+    }
+  }
+  return true;
+}
+
+// Stores the mapping into the cache. Only the mappings that are exactly
+// reproduced by the replay are stored, e.g., not the ones routed with the
+// congestion costs of the negotiated routing, so the replay is checked on
+// a copy of the CGRA.
+void Mapper::cacheMapping(CGRA* t_cgra, DFG* t_dfg, MappingCache* t_cache,
+    int t_II, bool t_isStaticElasticCGRA) {
+  vector<int> tiles;
+  vector<int> cycles;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    tiles.push_back(m_mapping[dfgNode]->getID());
+    cycles.push_back(m_mappingTiming[dfgNode]);
+  }
+  CGRA* cgra = new CGRA(t_cgra);
+  Mapper* mapper = fork(cgra, t_dfg);
+  bool replayed = mapper->replayMapping(cgra, t_dfg, t_II, &tiles, &cycles,
+                                        t_isStaticElasticCGRA) and
+                  isSameRouting(t_cgra, cgra, t_II);
+  delete mapper;
+  delete cgra;
+  // The DFG nodes are shared with the copy.
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->setMapped();
+  }
+  if (!replayed) {
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] mapping is not cached as it cannot be replayed\n";
+    return;
+  }
+  t_cache->store(t_II, &tiles, &cycles);
+}
+
+// Creates a mapper working on a copy of the CGRA, which takes over the
+// settings, the shared search context and the current mapping. The DFG
+// nodes are left untouched as they are shared by all the copies.
+Mapper* Mapper::fork(CGRA* t_cgra, DFG* t_dfg) {
+  Mapper* mapper = new Mapper(m_DVFSAwareMapping);
+  mapper->m_IISweepWidth = m_IISweepWidth;
+  mapper->m_searchTimeLimit = m_searchTimeLimit;
+  mapper->m_searchExpansionLimit = m_searchExpansionLimit;
+  mapper->m_searchBacktrackLimit = m_searchBacktrackLimit;
+  mapper->m_searchTaskDepth = m_searchTaskDepth;
+  mapper->m_searchMinimizeRouting = m_searchMinimizeRouting;
+  mapper->m_search = m_search;
+  mapper->initRouters(t_cgra, m_routers.size());
+  mapper->clearMapping(t_cgra);
+  mapper->m_maxMappingCycle = m_maxMappingCycle;
+  mapper->m_dfgNodeOrder = m_dfgNodeOrder;
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    if (m_mapping.find(dfgNode) != m_mapping.end()) {
+      mapper->setMapping(dfgNode, t_cgra->getNode(m_mapping[dfgNode]->getID()));
+      mapper->m_mappingTiming[dfgNode] = m_mappingTiming[dfgNode];
     }
-    // If the schedule fails and need to try the other schedule,
-    // should re-construct m_mapping and m_mappingTiming.
+  }
+  mapper->m_routingCost = m_routingCost;
+  return mapper;
+}
+
+// Sweeps the II like heuristicMap() unless the CGRA is static elastic.
+// The budgets are shared by all the IIs. Once any of them runs out, the
+// search gives up and the deepest partial mapping found so far is
+// restored and reported, unless the routing cost is minimized and some
+// mapping has already been found.
+int Mapper::exhaustiveMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA) {
+  // The predecessors and successors are lazily collected, which must not
+  // happen concurrently.
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    dfgNode->getPredNodes();
+    dfgNode->getSuccNodes();
+  }
+  SearchContext search;
+  search.timeLimit = m_searchTimeLimit;
+  search.expansionLimit = m_searchExpansionLimit;
+  search.backtrackLimit = m_searchBacktrackLimit;
+  search.start = chrono::steady_clock::now();
+  search.expansions = 0;
+  search.backtracks = 0;
+  search.bestCGRA = NULL;
+  search.bestMapper = NULL;
+  search.cgra = t_cgra;
+  search.deepestII = t_II;
+  m_search = &search;
+  bool success = false;
+  while (1) {
+    search.found = false;
+    search.bestCost = INT_MAX;
+    list<MappingPath> prefix;
+    // The MRRG is constructed only once per II, as the search backtracks
+    // by rolling back the changes recorded in the journal.
+    addStatsCount(STATS_II_ATTEMPTS, 1);
     constructMRRG(t_dfg, t_cgra, t_II);
-    list<DFGNode*>::iterator mappedDFGNodeItr = t_mappedDFGNodes->begin();
-    for (map<CGRANode*, int>* path: *t_exhaustivePaths) {
-      if (!schedule(t_cgra, t_dfg, t_II, *mappedDFGNodeItr, path,
+    if (m_searchTaskDepth == 0) {
+      t_cgra->enableJournal();
+      success = DFSMap(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA, &prefix);
+      t_cgra->disableJournal();
+    } else {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] exhaustive search spawns tasks for the first "
+          <<m_searchTaskDepth<<" DFG nodes with II="<<t_II<<"\n";
+      #pragma omp parallel
+      #pragma omp single
+      spawnSearchTasks(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA, &prefix,
+                       m_searchTaskDepth);
+    }
+    // The best mapping is kept on a copy of the CGRA unless the search
+    // stops at the first mapping in place.
+    if (search.bestMapper != NULL) {
+      t_cgra->copyMRRG(search.bestCGRA);
+      copyMapping(search.bestMapper, t_cgra, t_dfg);
+      delete search.bestMapper;
+      delete search.bestCGRA;
+      search.bestMapper = NULL;
+      search.bestCGRA = NULL;
+      success = true;
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] exhaustive search takes over the mapping with routing cost "
+          <<m_routingCost<<"\n";
+    }
+    showSearchProgress(t_II, search.deepestPaths.size(), t_dfg->nodes.size());
+    if (success or t_isStaticElasticCGRA or isOutOfBudget())
+      break;
+    ++t_II;
+  }
+  bool outOfBudget = !success and isOutOfBudget();
+  m_search = NULL;
+  if (success)
+    return t_II;
+
+  if (outOfBudget) {
+    int bestII = search.deepestII;
+    list<MappingPath>& bestPaths = search.deepestPaths;
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] exhaustive search runs out of budget; the deepest partial mapping with II="<<bestII
+        <<" maps "<<bestPaths.size()<<" out of "<<t_dfg->nodes.size()<<" DFG nodes\n";
+    constructMRRG(t_dfg, t_cgra, bestII);
+    list<DFGNode*>::iterator dfgNodeItr = t_dfg->nodes.begin();
+    for (MappingPath& path: bestPaths) {
+      if (!schedule(t_cgra, t_dfg, bestII, *dfgNodeItr, &path,
           t_isStaticElasticCGRA)) {
-        cout<<"DEBUG <this is impossible> fail7 in DFS() II: "<<t_II<<"\n";
-        assert(0);
+        LOG(LOG_LEVEL_ERROR)<<"DEBUG <this is impossible> fail to restore the partial mapping II: "<<bestII<<"\n";
         break;
       }
-      ++mappedDFGNodeItr;
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] partial mapping -- dfgNode: "<<(*dfgNodeItr)->getID()
+          <<" onto CGRANode: "<<m_mapping[*dfgNodeItr]->getID()
+          <<" at cycle: "<<m_mappingTiming[*dfgNodeItr]<<"\n";
+      ++dfgNodeItr;
     }
   }
-  if (t_exhaustivePaths->size() != 0) {
-    cout<<"======= go backward one step ======== popped DFG node ["<<t_mappedDFGNodes->back()->getID()<<"] from CGRA node ["<<m_mapping[t_mappedDFGNodes->back()]->getID()<<"]\n";
-    t_mappedDFGNodes->pop_back();
-    t_exhaustivePaths->pop_back();
-//    m_exit++;
-//    if (m_exit == 2)
-//      exit(0);
+  return -1;
+}
+
+void Mapper::setSearchBudget(long t_timeLimit, long t_expansionLimit,
+    long t_backtrackLimit) {
+  m_searchTimeLimit = t_timeLimit;
+  m_searchExpansionLimit = t_expansionLimit;
+  m_searchBacktrackLimit = t_backtrackLimit;
+}
+
+void Mapper::setSearchParallelism(int t_taskDepth, bool t_minimizeRouting) {
+  m_searchTaskDepth = t_taskDepth;
+  m_searchMinimizeRouting = t_minimizeRouting;
+}
+
+long Mapper::getSearchElapsedTime() {
+  return chrono::duration_cast<chrono::milliseconds>(
+      chrono::steady_clock::now() - m_search->start).count();
+}
+
+// A zero limit indicates the corresponding budget is unlimited.
+bool Mapper::isOutOfBudget() {
+  return (m_search->timeLimit > 0 and getSearchElapsedTime() >= m_search->timeLimit) or
+         (m_search->expansionLimit > 0 and m_search->expansions >= m_search->expansionLimit) or
+         (m_search->backtrackLimit > 0 and m_search->backtracks >= m_search->backtrackLimit);
+}
+
+// Workers stop once the budget runs out or, unless the routing cost is
+// minimized, once any of them finds a mapping.
+bool Mapper::isSearchStopped() {
+  return (m_search->found and !m_searchMinimizeRouting) or isOutOfBudget();
+}
+
+// A partial mapping is pruned once it routes as much as the best mapping,
+// as the routing cost never decreases while mapping more DFG nodes.
+bool Mapper::isBounded() {
+  return m_searchMinimizeRouting and m_routingCost >= m_search->bestCost;
+}
+
+void Mapper::showSearchProgress(int t_II, int t_depth, int t_dfgNodeCount) {
+  LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] exhaustive search progress -- II: "<<t_II
+      <<"; expansions: "<<m_search->expansions
+      <<"; backtracks: "<<m_search->backtracks
+      <<"; deepest: "<<t_depth<<"/"<<t_dfgNodeCount
+      <<"; elapsed: "<<getSearchElapsedTime()<<"ms\n";
+}
+
+// Keeps the scheduled paths if they map more DFG nodes than any partial
+// mapping found so far. The earliest one wins the ties.
+void Mapper::recordPartialMapping(int t_II, list<MappingPath>* t_paths) {
+  #pragma omp critical(search)
+  {
+    if (t_paths->size() > m_search->deepestPaths.size()) {
+      m_search->deepestPaths = *t_paths;
+      for (MappingPath& path: m_search->deepestPaths) {
+        path.rebase(m_search->cgra);
+      }
+      m_search->deepestII = t_II;
+    }
   }
-  delete potentialPaths;
-  return false;
 }
 
-// This helper function assume the cycle for each mapped CGRANode increases
-// gradually along the path. Otherwise, the map struct will get conflict key.
-map<int, CGRANode*>* Mapper::getReorderPath(map<CGRANode*, int>* t_path) {
-  map<int, CGRANode*>* reorderPath = new map<int, CGRANode*>();
-  for (map<CGRANode*, int>::iterator iter=t_path->begin();
-      iter!=t_path->end(); ++iter) {
-    assert(reorderPath->find((*iter).second) == reorderPath->end());
-    (*reorderPath)[(*iter).second] = (*iter).first;
+// Keeps a copy of the complete mapping if it is the first one or, when
+// the routing cost is minimized, cheaper than the best one.
+void Mapper::recordMapping(CGRA* t_cgra, DFG* t_dfg) {
+  #pragma omp critical(search)
+  {
+    if (m_searchMinimizeRouting ? m_routingCost < m_search->bestCost :
+        !m_search->found) {
+      delete m_search->bestMapper;
+      delete m_search->bestCGRA;
+      m_search->bestCGRA = new CGRA(t_cgra);
+      m_search->bestMapper = fork(m_search->bestCGRA, t_dfg);
+      m_search->bestCost = m_routingCost;
+      m_search->found = true;
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] exhaustive search finds a mapping with routing cost "
+          <<m_routingCost<<"\n";
+    }
+  }
+}
+
+// Expands the top 't_depth' levels of the search tree, where each
+// candidate of the next DFG node is scheduled by a task on its own copy
+// of the CGRA and the mapping. The tasks are picked up by the idle
+// threads of the enclosing parallel region, which balances the uneven
+// subtrees. The subtrees below are searched by DFSMap().
+void Mapper::spawnSearchTasks(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA, list<MappingPath>* t_prefix, int t_depth) {
+  if (t_prefix->size() == t_dfg->nodes.size()) {
+    recordMapping(t_cgra, t_dfg);
+    return;
+  }
+  if (t_depth == 0) {
+    t_cgra->enableJournal();
+    DFSMap(t_cgra, t_dfg, t_II, t_isStaticElasticCGRA, t_prefix);
+    t_cgra->disableJournal();
+    return;
+  }
+  list<DFGNode*>::iterator dfgNodeItr = t_dfg->nodes.begin();
+  advance(dfgNodeItr, t_prefix->size());
+  DFGNode* dfgNode = *dfgNodeItr;
+  vector<MappingPath> paths(t_cgra->getFUCount());
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<t_cgra->getColumns(); ++j) {
+      calculateCost(t_cgra, t_dfg, t_II, dfgNode, t_cgra->nodes[i][j],
+                    &paths[i*t_cgra->getColumns()+j]);
+    }
+  }
+  vector<MappingPath*> potentialPaths =
+      getOrderedPotentialPaths(t_cgra, t_dfg, t_II, dfgNode, &paths);
+  for (MappingPath* path: potentialPaths) {
+    if (isSearchStopped())
+      break;
+    CGRA* cgra = new CGRA(t_cgra);
+    Mapper* mapper = fork(cgra, t_dfg);
+    list<MappingPath>* prefix = new list<MappingPath>(*t_prefix);
+    prefix->push_back(*path);
+    for (MappingPath& prefixPath: *prefix) {
+      prefixPath.rebase(cgra);
+    }
+    #pragma omp task firstprivate(cgra, mapper, prefix)
+    {
+      if (!mapper->isSearchStopped()) {
+        ++mapper->m_search->expansions;
+        if (mapper->schedule(cgra, t_dfg, t_II, dfgNode, &prefix->back(),
+            t_isStaticElasticCGRA) and !mapper->isBounded()) {
+          mapper->recordPartialMapping(t_II, prefix);
+          mapper->spawnSearchTasks(cgra, t_dfg, t_II, t_isStaticElasticCGRA,
+                                   prefix, t_depth-1);
+        }
+      }
+      delete prefix;
+      delete mapper;
+      delete cgra;
+    }
+  }
+}
+
+// The candidates of a DFG node on the search stack.
+struct SearchFrame {
+  DFGNode* dfgNode;
+  vector<MappingPath> paths;
+  vector<MappingPath*> potentialPaths;
+  int next;
+  int mark;
+  int routingCost;
+};
+
+// Depth-first search over the ordered candidate paths of the DFG nodes
+// following the already scheduled 't_prefix', with an explicit stack
+// holding one frame per mapped DFG node. The first mapping is left in
+// place when searching sequentially, otherwise the mappings are recorded
+// in the search context.
+bool Mapper::DFSMap(CGRA* t_cgra, DFG* t_dfg, int t_II,
+    bool t_isStaticElasticCGRA, list<MappingPath>* t_prefix) {
+  vector<SearchFrame> stack;
+  stack.reserve(t_dfg->nodes.size());
+  list<DFGNode*>::iterator dfgNodeItr = t_dfg->nodes.begin();
+  advance(dfgNodeItr, t_prefix->size());
+  int bestDepth = t_prefix->size();
+  while (1) {
+    if (dfgNodeItr == t_dfg->nodes.end()) {
+      if (m_searchTaskDepth == 0 and !m_searchMinimizeRouting)
+        return true;
+      recordMapping(t_cgra, t_dfg);
+      if (!m_searchMinimizeRouting or stack.size() == 0)
+        return false;
+      // Keeps looking for a cheaper mapping with the other candidates.
+      --dfgNodeItr;
+      SearchFrame& top = stack.back();
+      t_cgra->rollback(top.mark);
+      removeMapping(top.dfgNode);
+      m_routingCost = top.routingCost;
+    } else {
+      // Collects the candidates of the next DFG node.
+      stack.push_back(SearchFrame());
+      SearchFrame& frame = stack.back();
+      frame.dfgNode = *dfgNodeItr;
+      frame.paths.resize(t_cgra->getFUCount());
+      for (int i=0; i<t_cgra->getRows(); ++i) {
+        for (int j=0; j<t_cgra->getColumns(); ++j) {
+          CGRANode* fu = t_cgra->nodes[i][j];
+          calculateCost(t_cgra, t_dfg, t_II, frame.dfgNode, fu,
+                        &frame.paths[i*t_cgra->getColumns()+j]);
+        }
+      }
+      frame.potentialPaths =
+          getOrderedPotentialPaths(t_cgra, t_dfg, t_II, frame.dfgNode, &frame.paths);
+      frame.next = 0;
+    }
+
+    // Tries the candidates of the DFG node on the top of the stack, and
+    // backtracks once all of them fail.
+    bool scheduled = false;
+    while (!scheduled and stack.size() != 0) {
+      SearchFrame& top = stack.back();
+      if (top.next == top.potentialPaths.size()) {
+        stack.pop_back();
+        if (stack.size() == 0)
+          break;
+        --dfgNodeItr;
+        SearchFrame& parent = stack.back();
+        LOG(LOG_LEVEL_TRACE)<<"======= go backward one step ======== popped DFG node ["<<parent.dfgNode->getID()<<"] from CGRA node ["<<m_mapping[parent.dfgNode]->getID()<<"]\n";
+        // Undoes the schedule of the parent DFG node.
+        t_cgra->rollback(parent.mark);
+        removeMapping(parent.dfgNode);
+        m_routingCost = parent.routingCost;
+        ++m_search->backtracks;
+        addStatsCount(STATS_BACKTRACKS, 1);
+        continue;
+      }
+      if (isSearchStopped())
+        return false;
+      MappingPath* currentPath = top.potentialPaths[top.next++];
+      assert(currentPath->size() != 0);
+      top.mark = t_cgra->getJournalMark();
+      top.routingCost = m_routingCost;
+      long expansions = ++m_search->expansions;
+      if (expansions % 100000 == 0)
+        showSearchProgress(t_II, bestDepth, t_dfg->nodes.size());
+      if (schedule(t_cgra, t_dfg, t_II, top.dfgNode, currentPath,
+          t_isStaticElasticCGRA) and !isBounded()) {
+        scheduled = true;
+      } else {
+        // If the schedule fails and need to try the other schedule,
+        // should roll back the MRRG, m_mapping and m_mappingTiming.
+        t_cgra->rollback(top.mark);
+        removeMapping(top.dfgNode);
+        m_routingCost = top.routingCost;
+      }
+    }
+    if (!scheduled)
+      return false;
+    ++dfgNodeItr;
+    if (t_prefix->size() + stack.size() > bestDepth) {
+      bestDepth = t_prefix->size() + stack.size();
+      list<MappingPath> paths(*t_prefix);
+      for (SearchFrame& frame: stack) {
+        paths.push_back(*frame.potentialPaths[frame.next-1]);
+      }
+      recordPartialMapping(t_II, &paths);
+    }
   }
-  assert(reorderPath->size() == t_path->size());
-  return reorderPath;
 }
 
 // Saves the mapping results to json file for subsequent incremental mapping.
 void Mapper::generateJSON4IncrementalMap(CGRA* t_cgra, DFG* t_dfg){
-  ofstream jsonFile("increMapInput.json", ios::out);
-  jsonFile<<"{"<<endl;
-  jsonFile<<"     \"Opt2TileXY\":{"<<endl;
+  ScopedTimer timer(STATS_WRITE_JSON);
+  // The whole file is assembled in memory and written out at once.
+  ostringstream jsonFile;
+  jsonFile<<"{"<<"\n";
+  jsonFile<<"     \"Opt2TileXY\":{"<<"\n";
   int idx = 0;
   for (DFGNode* dfgNode: t_dfg->nodes) {
     // Writes dfgnodeID, mapped CGRANode X and Y coordinates.i
     // opt id.
-    jsonFile<<"             \""<<dfgNode->getID()<<"\": {"<<endl;
+    jsonFile<<"             \""<<dfgNode->getID()<<"\": {"<<"\n";
     // opt mapped tile x coordinate.
-    jsonFile<<"                     \"x\":"<<m_mapping[dfgNode]->getX()<<","<<endl;
+    jsonFile<<"                     \"x\":"<<m_mapping[dfgNode]->getX()<<","<<"\n";
     // opt mapped tile y coordinate.
-    jsonFile<<"                     \"y\":"<<m_mapping[dfgNode]->getY()<<endl;
+    jsonFile<<"                     \"y\":"<<m_mapping[dfgNode]->getY()<<"\n";
     idx += 1;
-    if (idx < t_dfg->nodes.size()) jsonFile<<"             },"<<endl;
-    else jsonFile<<"        }"<<endl;
+    if (idx < t_dfg->nodes.size()) jsonFile<<"             },"<<"\n";
+    else jsonFile<<"        }"<<"\n";
   }
-  jsonFile<<"     },"<<endl;
+  jsonFile<<"     },"<<"\n";
 
-  jsonFile<<"     \"Tile2Level\":{"<<endl;
+  jsonFile<<"     \"Tile2Level\":{"<<"\n";
   // Generates level informations of current mapping results.
   // FanIO is the number of links of current CGRANode connected to other CGRANode,
   // and FanIO_CGRANodes can help with querying the list of CGRANodes with the given FanIO.
@@ -1782,21 +3084,22 @@ void Mapper::generateJSON4IncrementalMap(CGRA* t_cgra, DFG* t_dfg){
     vector<CGRANode*> tiles = FanIO_CGRANodes[FanIO];
     for (auto tile : tiles) {
       idx += 1;
-      if (idx < numTiles) jsonFile<<"          \""<<tile->getID()<<"\":"<<level<<","<<endl;
-      else jsonFile<<"             \""<<tile->getID()<<"\":"<<level<<endl;
+      if (idx < numTiles) jsonFile<<"          \""<<tile->getID()<<"\":"<<level<<","<<"\n";
+      else jsonFile<<"             \""<<tile->getID()<<"\":"<<level<<"\n";
     }
   }
-  jsonFile<<"     }"<<endl;
+  jsonFile<<"     }"<<"\n";
 
-  jsonFile<<"}"<<endl;
-  jsonFile.close();
+  jsonFile<<"}"<<"\n";
+  ofstream increMapFile("increMapInput.json", ios::out);
+  increMapFile<<jsonFile.str();
 }
 
 // Reads from the referenced mapping results json file and generates variables for incremental mapping.
 int Mapper::readRefMapRes(CGRA* t_cgra, DFG* t_dfg){
   ifstream refFile("./increMapInput.json");
   if (!refFile.good()) {
-    cout<<"Incremental mapping requires increMapInput.json in current directory!"<<endl;
+    LOG(LOG_LEVEL_ERROR)<<"Incremental mapping requires increMapInput.json in current directory!"<<endl;
     return -1;
   }
   json refs;
@@ -1861,7 +3164,7 @@ list<CGRANode*> Mapper::placementGen(CGRA* t_cgra,  DFGNode* t_dfgNode){
   int refLevel = CGRANodeID2Level[refCGRANode->getID()];
   int level = refLevel;
   int maxLevel = CGRANodes_sortedByLevel.size() - 1;
-  cout<<t_dfgNode->getOpcodeName()<<t_dfgNode->getID()<<" is mapped to Tile "<<refCGRANode->getID()<<" in the referenced mapping results, refLevel="<<refLevel<<endl;
+  LOG(LOG_LEVEL_DEBUG)<<t_dfgNode->getOpcodeName()<<t_dfgNode->getID()<<" is mapped to Tile "<<refCGRANode->getID()<<" in the referenced mapping results, refLevel="<<refLevel<<"\n";
 
   int initLevel = level;
   while (true) {
@@ -1910,29 +3213,30 @@ int Mapper::incrementalMap(CGRA* t_cgra, DFG* t_dfg, int t_II){
 
   bool dfgNodeMapFailed;
   while (1) {
-    cout<<"----------------------------------------\n";
-    cout<<"[DEBUG] start incremental mapping  with II="<<t_II<<"\n";
+    LOG(LOG_LEVEL_DEBUG)<<"----------------------------------------\n";
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] start incremental mapping  with II="<<t_II<<"\n";
     int cycle = 0;
+    addStatsCount(STATS_II_ATTEMPTS, 1);
     constructMRRG(t_dfg, t_cgra, t_II);
     for (list<DFGNode*>::iterator dfgNode=t_dfg->nodes.begin(); dfgNode!=t_dfg->nodes.end(); dfgNode++) {
       list<CGRANode*> placementRecommList = placementGen(t_cgra, *dfgNode);
       dfgNodeMapFailed = true;
+      MappingPath path;
       for (auto fu : placementRecommList) {
-        map<CGRANode*, int>* path = calculateCost(t_cgra, t_dfg, t_II, *dfgNode, fu);
-        if (path == NULL) {
+        if (!calculateCost(t_cgra, t_dfg, t_II, *dfgNode, fu, &path)) {
           // Switches to the next tile.
-          cout<<"[DEBUG] no available path for DFG node "<<(*dfgNode)->getID()<<" on CGRA node "<<fu->getID()<<" within II "<<t_II<<endl;
+          LOG(LOG_LEVEL_TRACE)<<"[DEBUG] no available path for DFG node "<<(*dfgNode)->getID()<<" on CGRA node "<<fu->getID()<<" within II "<<t_II<<"\n";
           continue;
         }
         else {
-          if (schedule(t_cgra, t_dfg, t_II, *dfgNode, path, false)) {
+          if (schedule(t_cgra, t_dfg, t_II, *dfgNode, &path, false)) {
             // Current DFGNode is scheduled successfully, moves to the next DFGNode.
             dfgNodeMapFailed = false;
             break;
           }
           else {
             // Switches to the next tile.
-            cout<<"[DEBUG] no available path to schedule DFG node "<<(*dfgNode)->getID()<<" on CGRA node "<<fu->getID()<<" within II "<<t_II<<endl;
+            LOG(LOG_LEVEL_TRACE)<<"[DEBUG] no available path to schedule DFG node "<<(*dfgNode)->getID()<<" on CGRA node "<<fu->getID()<<" within II "<<t_II<<"\n";
             continue;
           }
         }
@@ -1942,11 +3246,11 @@ int Mapper::incrementalMap(CGRA* t_cgra, DFG* t_dfg, int t_II){
     }
 
     if (dfgNodeMapFailed) {
-      cout<<"[DEBUG] fail in schedule() under II: "<<t_II<<"\n";
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] fail in schedule() under II: "<<t_II<<"\n";
       t_II++;
     }
     else {
-      cout<<"[DEBUG] success in schedule() under II: "<<t_II<<"\n";
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] success in schedule() under II: "<<t_II<<"\n";
       return t_II;
     }
   }
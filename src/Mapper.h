@@ -10,22 +10,127 @@
 
 #include "DFG.h"
 #include "CGRA.h"
+#include "Router.h"
+#include "MappingCache.h"
+#include <atomic>
+#include <chrono>
+
+// The cost of a candidate path along with its position among the
+// candidates, which breaks the ties deterministically.
+struct PathCost {
+  float cost;
+  int order;
+  MappingPath* path;
+};
+
+// A reservation made on the MRRG by a route, i.e., a slot of the link or,
+// without link, a register of the tile keeping the data locally.
+struct Reservation {
+  CGRALink* link;
+  CGRANode* tile;
+  int cycle;
+  int duration;
+  bool isBypass;
+  bool isGeneratedOut;
+};
+
+// The reservations delivering the data of the source DFG node to the
+// destination one, which are recorded so that the route can be restored
+// without searching it again.
+struct Route {
+  DFGNode* src;
+  DFGNode* dst;
+  vector<Reservation> reservations;
+};
+
+// A DFG node placed by the heuristic mapping along with the journal mark
+// taken right before its schedule, which allows to unschedule it, and the
+// routes made by the schedule. A placement without DFG node only carries
+// the routes made afterwards, e.g., by the negotiated routing.
+struct Placement {
+  DFGNode* dfgNode;
+  CGRANode* tile;
+  int cycle;
+  int mark;
+  vector<Route> routes;
+};
+
+class Mapper;
+
+// The state of an exhaustive search shared by all its workers. The
+// counters and the budgets (zero indicates unlimited) cover the whole II
+// sweep, while the others are reset for each II.
+struct SearchContext {
+  long timeLimit;
+  long expansionLimit;
+  long backtrackLimit;
+  chrono::steady_clock::time_point start;
+  atomic<long> expansions;
+  atomic<long> backtracks;
+  // Set once a mapping is found, which stops all the workers unless the
+  // routing cost is minimized.
+  atomic<bool> found;
+  // The routing cost of the best mapping, which bounds the search when
+  // the routing cost is minimized.
+  atomic<int> bestCost;
+  // Copies of the best mapping, unless it is kept in place by the
+  // sequential search.
+  CGRA* bestCGRA;
+  Mapper* bestMapper;
+  // The deepest partial mapping of the sweep, whose paths are on the
+  // CGRA being mapped rather than its copies.
+  CGRA* cgra;
+  list<MappingPath> deepestPaths;
+  int deepestII;
+};
 
 class Mapper {
   private:
     int m_maxMappingCycle;
     map<DFGNode*, CGRANode*> m_mapping;
     map<DFGNode*, int> m_mappingTiming;
-    map<CGRANode*, int>* dijkstra_search(CGRA*, DFG*, int, DFGNode*,
-                                         DFGNode*, CGRANode*);
+    // One router per OpenMP thread, as the candidate tiles are evaluated
+    // in parallel and each search owns its scratch buffers.
+    vector<Router*> m_routers;
+    Router* getRouter();
+    bool dijkstra_search(CGRA*, DFG*, int, DFGNode*, DFGNode*, CGRANode*,
+                         MappingPath*);
     int getMaxMappingCycle();
+    bool hasPositiveCycle(int, vector<int>*, vector<int>*, vector<int>*,
+                          vector<int>*, int);
+    void searchRoutes(CGRA*, int, Router*, DFGNode*, CGRANode*, int,
+                      CGRANode*);
     bool tryToRoute(CGRA*, DFG*, int, DFGNode*, CGRANode*,
-                    DFGNode*, CGRANode*, int, bool, bool);
-    list<DFGNode*>* getMappedDFGNodes(DFG*, CGRANode*);
-    map<int, CGRANode*>* getReorderPath(map<CGRANode*, int>*);
-    bool DFSMap(CGRA*, DFG*, int, list<DFGNode*>*, list<map<CGRANode*, int>*>*, bool);
-    list<map<CGRANode*, int>*>* getOrderedPotentialPaths(CGRA*, DFG*, int,
-        DFGNode*, list<map<CGRANode*, int>*>*);
+                    DFGNode*, CGRANode*, int, bool, bool,
+                    bool t_isDeadline=false);
+    // The position of each DFG node in the mapping order, in which a DFG
+    // node is placed after the predecessors it is timed by.
+    map<DFGNode*, int> m_dfgNodeOrder;
+    bool precedes(DFGNode*, DFGNode*);
+    bool isInSameCycle(DFGNode*, DFGNode*);
+    // The routes made since the last schedule() started, which are kept
+    // by the placement.
+    vector<Route> m_newRoutes;
+    Route* addRoute(DFGNode*, DFGNode*);
+    void restoreRoute(int, Route*, bool);
+    bool routeOrDefer(CGRA*, DFG*, int, DFGNode*, DFGNode*, bool, bool, bool,
+                      vector<Route>*);
+    // Reverse index of the mapping, i.e., the DFG nodes mapped onto each
+    // tile and the number of high fanout ones among them, indexed by the
+    // tile ID and updated along with 'm_mapping'.
+    vector<list<DFGNode*>> m_tileDFGNodes;
+    vector<int> m_tileHighFanouts;
+    list<DFGNode*>* getMappedDFGNodes(CGRANode*);
+    bool isHighFanout(DFGNode*);
+    void clearMapping(CGRA*);
+    void setMapping(DFGNode*, CGRANode*);
+    void removeMapping(DFGNode*);
+    bool DFSMap(CGRA*, DFG*, int, bool, list<MappingPath>*);
+    void spawnSearchTasks(CGRA*, DFG*, int, bool, list<MappingPath>*, int);
+    void scorePotentialPaths(CGRA*, DFG*, int, DFGNode*,
+        vector<MappingPath>*, vector<PathCost>*);
+    vector<MappingPath*> getOrderedPotentialPaths(CGRA*, DFG*, int,
+        DFGNode*, vector<MappingPath>*);
     // The mapping relationship referenced by incrementalMap, read from increMapInput.json file
     map<DFGNode*, CGRANode*> refMapRes;
     // One to one relationship between CGRANode and its level
@@ -33,19 +138,105 @@ class Mapper {
     // The list of CGRANodes sorted by levels
     vector<vector<CGRANode*>> CGRANodes_sortedByLevel;
     bool m_DVFSAwareMapping;
+    // Number of consecutive IIs that are mapped concurrently.
+    int m_IISweepWidth;
+    bool heuristicMapWithII(CGRA*, DFG*, int, bool, atomic<int>* t_mappedII=NULL);
+    // Negotiated congestion routing of a failed placement, i.e., the nets
+    // holding the slots the placement contests are ripped up and routed
+    // again for at most 'm_negotiationIterations' iterations, in which
+    // the history cost of the contested slots (indexed by the link ID and
+    // then the slot) grows along with the price of the overuse.
+    bool m_negotiatedRouting;
+    int m_negotiationIterations;
+    vector<float> m_linkHistory;
+    void setCongestion(vector<float>*, float);
+    bool negotiatePlacement(CGRA*, DFG*, int, DFGNode*, bool,
+                            vector<Placement>*);
+    float probePlacement(CGRA*, int, DFGNode*, CGRANode*, float,
+                         set<pair<int, int>>*, set<DFGNode*>*);
+    float probeRoute(CGRA*, int, DFGNode*, CGRANode*, int, CGRANode*, int,
+                     float, int*, set<pair<int, int>>*, set<DFGNode*>*);
+    void addContestedSlots(CGRA*, int, DFGNode*, CGRANode*, MappingPath*,
+                           set<pair<int, int>>*, set<DFGNode*>*);
+    void routePending(CGRA*, DFG*, int, vector<Route>*, bool,
+                      vector<Placement>*);
+    // Number of the repair attempts of a failed placement before the
+    // heuristic mapping gives up the II, where 0 disables the repair.
+    int m_repairAttempts;
+    bool placeDFGNode(CGRA*, DFG*, int, DFGNode*, vector<MappingPath>*, bool,
+                      vector<Placement>*, CGRANode* t_avoidTile=NULL);
+    bool placeDFGNodeOnTile(CGRA*, DFG*, int, DFGNode*, CGRANode*, bool,
+                            vector<Placement>*);
+    bool repairPlacement(CGRA*, DFG*, int, DFGNode*, vector<MappingPath>*,
+                         bool, vector<Placement>*);
+    bool expandRepairNeighborhood(CGRA*, int, DFGNode*, set<DFGNode*>*);
+    void addPlacement(CGRA*, DFGNode*, int, vector<Placement>*);
+    int unschedule(CGRA*, int, set<DFGNode*>*, set<DFGNode*>*, bool,
+                   vector<Placement>*, vector<Placement>*, vector<Route>*);
+    void reschedule(CGRA*, int, int, bool, vector<Placement>*,
+                    vector<Route>*, vector<Placement>*);
+    // Wall-clock time in ms of the simulated annealing refinement of a
+    // successful mapping, where 0 disables the refinement.
+    long m_refinementTimeLimit;
+    // Whether generateJSON() also writes config.bin (see ConfigBinary.h).
+    bool m_binaryConfig;
+    int getMappingCost(CGRA*, int);
+    int recountMappingCost(CGRA*, int, set<CGRALink*>*, set<CGRANode*>*,
+                           vector<int>*, vector<pair<int, int>>*);
+    bool placeOnTiles(CGRA*, DFG*, int, vector<DFGNode*>*, vector<CGRANode*>*,
+                      int, bool, vector<Placement>*);
+    int parallelHeuristicMap(CGRA*, DFG*, int);
+    void copyMapping(Mapper*, CGRA*, DFG*);
+    void initRouters(CGRA*, int);
+    Mapper* fork(CGRA*, DFG*);
+    // Budgets of the exhaustive search (zero indicates unlimited), i.e.,
+    // the wall-clock time in ms and the number of expansions (i.e., the
+    // schedule attempts) and backtracks.
+    long m_searchTimeLimit;
+    long m_searchExpansionLimit;
+    long m_searchBacktrackLimit;
+    // Number of the top levels of the exhaustive search whose candidates
+    // are searched as parallel tasks, where 0 searches sequentially.
+    int m_searchTaskDepth;
+    // Whether the exhaustive search keeps looking for the mapping with
+    // the lowest routing cost (i.e., the number of link occupancies)
+    // rather than stopping at the first one.
+    bool m_searchMinimizeRouting;
+    SearchContext* m_search;
+    int m_routingCost;
+    long getSearchElapsedTime();
+    bool isSearchStopped();
+    bool isBounded();
+    bool isOutOfBudget();
+    void showSearchProgress(int, int, int);
+    void recordPartialMapping(int, list<MappingPath>*);
+    void recordMapping(CGRA*, DFG*);
+    bool replayMapping(CGRA*, DFG*, int, vector<int>*, vector<int>*, bool);
 
   public:
     Mapper(bool);
+    ~Mapper();
+    void setIISweepWidth(int);
+    void setSearchBudget(long, long, long);
+    void setSearchParallelism(int, bool);
+    void setNegotiatedRouting(bool, int);
+    void setRepairAttempts(int);
+    void setRefinementTimeLimit(long);
+    void setBinaryConfig(bool);
     int getResMII(DFG*, CGRA*);
     int getRecMII(DFG*);
     int getExpandableII(DFG*, int);
     void constructMRRG(DFG*, CGRA*, int);
     int heuristicMap(CGRA*, DFG*, int, bool);
+    void refineMapping(CGRA*, DFG*, int, bool, bool);
     int exhaustiveMap(CGRA*, DFG*, int, bool);
-    map<CGRANode*, int>* calculateCost(CGRA*, DFG*, int, DFGNode*, CGRANode*);
-    map<CGRANode*, int>* getPathWithMinCostAndConstraints(CGRA*, DFG*, int,
-        DFGNode*, list<map<CGRANode*, int>*>*);
-    bool schedule(CGRA*, DFG*, int, DFGNode*, map<CGRANode*, int>*, bool);
+    int cachedMap(CGRA*, DFG*, MappingCache*, bool);
+    void cacheMapping(CGRA*, DFG*, MappingCache*, int, bool);
+    bool calculateCost(CGRA*, DFG*, int, DFGNode*, CGRANode*, MappingPath*);
+    MappingPath* getPathWithMinCostAndConstraints(CGRA*, DFG*, int,
+        DFGNode*, vector<MappingPath>*);
+    bool schedule(CGRA*, DFG*, int, DFGNode*, MappingPath*, bool,
+                  vector<Route>* t_unrouted=NULL);
     void showSchedule(CGRA*, DFG*, int, bool, bool);
     void showUtilization(CGRA*, DFG*, int, bool, bool);
     void generateJSON(CGRA*, DFG*, int, bool);
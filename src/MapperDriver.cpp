@@ -0,0 +1,506 @@
+/*
+ * ======================================================================
+ * MapperDriver.cpp
+ * ======================================================================
+ * Mapper driver implementation, i.e., the parameters and the mapping flow
+ * shared by the mapper pass and the standalone mapper.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include "MapperDriver.h"
+#include "Logger.h"
+#include "MapperStats.h"
+#include "json.hpp"
+#include <fstream>
+#include <set>
+
+// Used to walkaround the mis-interpret of LLVM opcode in github
+// testing infra: https://github.com/tancheng/CGRA-Mapper/pull/27#issuecomment-2495202802
+extern int testing_opcode_offset;
+
+using json = nlohmann::json;
+
+MapperParams::MapperParams() {
+  rows                      = 4;
+  columns                   = 4;
+  targetEntireFunction      = false;
+  targetNested              = false;
+  doCGRAMapping             = true;
+  isStaticElasticCGRA       = false;
+  isTrimmedDemo             = true;
+  ctrlMemConstraint         = 200;
+  bypassConstraint          = 4;
+  regConstraint             = 8;
+  precisionAware            = false;
+  vectorizationMode         = "all";
+  heuristicMapping          = true;
+  parameterizableCGRA       = false;
+
+  // Incremental mapping related:
+  // https://github.com/tancheng/CGRA-Mapper/pull/24
+  incrementalMapping        = false;
+
+  // Number of consecutive IIs tried concurrently by the heuristic
+  // mapping, each on its own copy of the CGRA.
+  IISweepWidth              = 1;
+
+  // Budgets of the exhaustive mapping, i.e., the wall-clock time in
+  // ms, the schedule attempts, and the backtracks. 0 is unlimited.
+  exhaustiveTimeLimit       = 0;
+  exhaustiveExpansionLimit  = 0;
+  exhaustiveBacktrackLimit  = 0;
+  // Number of the top DFG nodes whose candidates are searched as
+  // parallel tasks by the exhaustive mapping (0 is sequential), and
+  // whether it keeps searching for the lowest routing cost.
+  exhaustiveTaskDepth       = 0;
+  exhaustiveMinimizeRouting = false;
+
+  // Negotiated congestion routing of a failed placement of the
+  // heuristic mapping, which rips up and routes again the contested
+  // nets at most the given times before moving on.
+  negotiatedRouting         = false;
+  negotiationIterations     = 8;
+
+  // Number of the attempts to repair a failed placement of the
+  // heuristic mapping by ripping up its neighborhood before moving on
+  // to the next II. 0 disables the repair.
+  repairAttempts            = 0;
+
+  // Wall-clock time in ms of the simulated annealing refinement of the
+  // placement once the heuristic mapping succeeds, with the II fixed.
+  // 0 disables the refinement.
+  refinementTimeLimit       = 0;
+
+  // Directory of the on-disk mapping cache, which reuses the mapping
+  // of the same DFG, CGRA and mapper options. Empty disables it.
+  mappingCacheDir           = "";
+
+  // Writes config.bin (see ConfigBinary.h) along with config.json.
+  binaryConfig              = false;
+
+  // DVFS-related options.
+  supportDVFS               = false;
+  DVFSAwareMapping          = false;
+  DVFSIslandDim             = 2;
+  enablePowerGating         = false;
+  enableExpandableMapping   = false;
+
+  // Option used to split one integer division into 4.
+  // https://github.com/tancheng/CGRA-Mapper/pull/27#issuecomment-2480362586
+  vectorFactorForIdiv       = 1;
+  multiCycleStrategy        = "exclusive";
+
+  execLatency    = new map<string, int>();
+  pipelinedOpt   = new list<string>();
+  fusionStrategy = new list<string>();
+  additionalFunc = new map<string, list<int>*>();
+  fusionPattern  = new map<string, list<string>*>();
+  kernel         = "";
+}
+
+// Reads the parameters from the given JSON file. Returns false if there is
+// no such file, in which case the defaults are kept.
+bool readParams(string t_fileName, MapperParams* t_params) {
+  ifstream i(t_fileName);
+  if (!i.good()) {
+
+    LOG(LOG_LEVEL_ERROR)<< "=============================================================\n";
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31mPlease provide a valid <param.json> in the current directory."<<endl;
+    LOG(LOG_LEVEL_ERROR)<<"A set of default parameters is leveraged.\033[0m"<<endl;
+    LOG(LOG_LEVEL_ERROR)<< "=============================================================\n";
+    return false;
+  }
+  json param;
+  i >> param;
+
+  // The log level goes first to cover the messages below.
+  if (param.find("logLevel") != param.end() and
+      !setLogLevel(param["logLevel"].get<string>())) {
+    LOG(LOG_LEVEL_ERROR)<<"Unknown logLevel in param.json: "<<param["logLevel"]
+                        <<" (off, error, info, debug or trace)"<<endl;
+  }
+
+  // Check param exist or not.
+  set<string> paramKeys;
+  paramKeys.insert("row");
+  paramKeys.insert("column");
+  paramKeys.insert("targetFunction");
+  paramKeys.insert("kernel");
+  paramKeys.insert("targetNested");
+  paramKeys.insert("targetLoopsID");
+  paramKeys.insert("isTrimmedDemo");
+  paramKeys.insert("doCGRAMapping");
+  paramKeys.insert("isStaticElasticCGRA");
+  paramKeys.insert("ctrlMemConstraint");
+  paramKeys.insert("bypassConstraint");
+  paramKeys.insert("regConstraint");
+  paramKeys.insert("precisionAware");
+  paramKeys.insert("vectorizationMode");
+  paramKeys.insert("fusionStrategy");
+  paramKeys.insert("heuristicMapping");
+  paramKeys.insert("parameterizableCGRA");
+
+  try
+  {
+    // try to access a nonexisting key
+    for (auto itr : paramKeys)
+    {
+      param.at(itr);
+    }
+  }
+  catch (json::out_of_range& e)
+  {
+    LOG(LOG_LEVEL_ERROR)<<"Please include related parameter in param.json: "<<e.what()<<endl;
+    exit(0);
+  }
+
+  t_params->kernel = param["kernel"];
+  json loops = param["targetLoopsID"];
+  for (int i=0; i<loops.size(); ++i) {
+    t_params->targetLoopsID.push_back(loops[i]);
+  }
+
+  // Configuration for customizable CGRA.
+  t_params->rows                  = param["row"];
+  t_params->columns               = param["column"];
+  t_params->targetEntireFunction  = param["targetFunction"];
+  t_params->targetNested          = param["targetNested"];
+  t_params->doCGRAMapping         = param["doCGRAMapping"];
+  t_params->isStaticElasticCGRA   = param["isStaticElasticCGRA"];
+  t_params->isTrimmedDemo         = param["isTrimmedDemo"];
+  t_params->ctrlMemConstraint     = param["ctrlMemConstraint"];
+  t_params->bypassConstraint      = param["bypassConstraint"];
+  t_params->regConstraint         = param["regConstraint"];
+  t_params->precisionAware        = param["precisionAware"];
+  t_params->vectorizationMode     = param["vectorizationMode"];
+  t_params->heuristicMapping      = param["heuristicMapping"];
+  t_params->parameterizableCGRA   = param["parameterizableCGRA"];
+
+  if (param.find("incrementalMapping") != param.end()) {
+    t_params->incrementalMapping = param["incrementalMapping"];
+  }
+  if (param.find("IISweepWidth") != param.end()) {
+    t_params->IISweepWidth = param["IISweepWidth"];
+  }
+  if (param.find("exhaustiveTimeLimit") != param.end()) {
+    t_params->exhaustiveTimeLimit = param["exhaustiveTimeLimit"];
+  }
+  if (param.find("exhaustiveExpansionLimit") != param.end()) {
+    t_params->exhaustiveExpansionLimit = param["exhaustiveExpansionLimit"];
+  }
+  if (param.find("exhaustiveBacktrackLimit") != param.end()) {
+    t_params->exhaustiveBacktrackLimit = param["exhaustiveBacktrackLimit"];
+  }
+  if (param.find("exhaustiveTaskDepth") != param.end()) {
+    t_params->exhaustiveTaskDepth = param["exhaustiveTaskDepth"];
+  }
+  if (param.find("exhaustiveMinimizeRouting") != param.end()) {
+    t_params->exhaustiveMinimizeRouting = param["exhaustiveMinimizeRouting"];
+  }
+  if (param.find("negotiatedRouting") != param.end()) {
+    t_params->negotiatedRouting = param["negotiatedRouting"];
+  }
+  if (param.find("negotiationIterations") != param.end()) {
+    t_params->negotiationIterations = param["negotiationIterations"];
+  }
+  if (param.find("repairAttempts") != param.end()) {
+    t_params->repairAttempts = param["repairAttempts"];
+  }
+  if (param.find("refinementTimeLimit") != param.end()) {
+    t_params->refinementTimeLimit = param["refinementTimeLimit"];
+  }
+  if (param.find("mappingCacheDir") != param.end()) {
+    t_params->mappingCacheDir = param["mappingCacheDir"];
+  }
+  if (param.find("binaryConfig") != param.end()) {
+    t_params->binaryConfig = param["binaryConfig"];
+  }
+  if (param.find("supportDVFS") != param.end()) {
+    t_params->supportDVFS = param["supportDVFS"];
+  }
+  if (param.find("DVFSAwareMapping") != param.end()) {
+    t_params->DVFSAwareMapping = param["DVFSAwareMapping"];
+  }
+  if (param.find("DVFSIslandDim") != param.end()) {
+    t_params->DVFSIslandDim = param["DVFSIslandDim"];
+  }
+  if (param.find("enablePowerGating") != param.end()) {
+    t_params->enablePowerGating = param["enablePowerGating"];
+  }
+  if (param.find("expandableMapping") != param.end()) {
+    t_params->enableExpandableMapping = param["expandableMapping"];
+  }
+
+  if (param.find("vectorFactorForIdiv ") != param.end()) {
+    t_params->vectorFactorForIdiv = param["vectorFactorForIdiv "];
+  }
+  if (param.find("testingOpcodeOffset") != param.end()) {
+    testing_opcode_offset = param["testingOpcodeOffset"];
+  }
+  if (param.find("multiCycleStrategy") != param.end()) {
+    t_params->multiCycleStrategy = param["multiCycleStrategy"];
+    // Strategy Definition
+    // Exclusive: Multi-cyce operations occupy tiles exclusively. Other operations can be mapped onto this tile only if the multi-cycle operation finishs its computation.
+    // Distributed: Multi-cycle operations are splitted into multiple single-cycle operations and each of which can be mapped onto a tile.
+    // Inclusive: Multi-cycle operations' execution can overlap with other operations on the same tile.
+    // Note that
+    assert(t_params->multiCycleStrategy.compare("exclusive") == 0 or
+           t_params->multiCycleStrategy.compare("distributed") == 0 or
+           t_params->multiCycleStrategy.compare("inclusive") == 0);
+  }
+  LOG(LOG_LEVEL_INFO)<<"Initialize opt latency for DFG nodes: \n";
+  for (auto& opt : param["optLatency"].items()) {
+    LOG(LOG_LEVEL_INFO)<<opt.key()<<" : "<<opt.value()<<"\n";
+    (*t_params->execLatency)[opt.key()] = opt.value();
+  }
+  json pipeOpt = param["optPipelined"];
+  for (int i=0; i<pipeOpt.size(); ++i) {
+    t_params->pipelinedOpt->push_back(pipeOpt[i]);
+  }
+  LOG(LOG_LEVEL_INFO)<<"Deciding fusion strategy for DFG nodes: \n";
+  for (auto& opt : param["fusionStrategy"].items()) {
+    t_params->fusionStrategy->push_back(opt.value());
+  }
+  LOG(LOG_LEVEL_INFO)<<"Initialize additional functionality on CGRA nodes: \n";
+  for (auto& opt : param["additionalFunc"].items()) {
+    (*t_params->additionalFunc)[opt.key()] = new list<int>();
+    LOG(LOG_LEVEL_INFO)<<opt.key()<<" : "<<opt.value()<<": ";
+    for (int i=0; i<opt.value().size(); ++i) {
+      (*t_params->additionalFunc)[opt.key()]->push_back(opt.value()[i]);
+      LOG(LOG_LEVEL_INFO)<<opt.value()[i]<<" ";
+    }
+    LOG(LOG_LEVEL_INFO)<<"\n";
+  }
+  LOG(LOG_LEVEL_INFO)<<"Finding fusion pattern for DFG: \n";
+  for (auto& opt : param["fusionPattern"].items()) {
+    (*t_params->fusionPattern)[opt.key()] = new list<string>();
+    LOG(LOG_LEVEL_INFO)<<opt.key()<<" : "<<opt.value()<<": ";
+    for (int i=0; i<opt.value().size(); ++i) {
+      (*t_params->fusionPattern)[opt.key()]->push_back(opt.value()[i]);
+      LOG(LOG_LEVEL_INFO)<<opt.value()[i]<<" ";
+    }
+    LOG(LOG_LEVEL_INFO)<<"\n";
+  }
+  return true;
+}
+
+CGRA* createCGRA(MapperParams* t_params) {
+  const bool enableMultipleOps =
+      t_params->multiCycleStrategy.compare("inclusive") == 0;
+  CGRA* cgra = new CGRA(t_params->rows, t_params->columns,
+                        t_params->vectorizationMode, t_params->fusionStrategy,
+                        t_params->parameterizableCGRA,
+                        t_params->additionalFunc, t_params->supportDVFS,
+                        t_params->DVFSIslandDim, enableMultipleOps);
+  cgra->setRegConstraint(t_params->regConstraint);
+  cgra->setCtrlMemConstraint(t_params->ctrlMemConstraint);
+  cgra->setBypassConstraint(t_params->bypassConstraint);
+  return cgra;
+}
+
+Mapper* createMapper(MapperParams* t_params) {
+  Mapper* mapper = new Mapper(t_params->DVFSAwareMapping);
+  mapper->setIISweepWidth(t_params->IISweepWidth);
+  mapper->setSearchBudget(t_params->exhaustiveTimeLimit,
+                          t_params->exhaustiveExpansionLimit,
+                          t_params->exhaustiveBacktrackLimit);
+  mapper->setSearchParallelism(t_params->exhaustiveTaskDepth,
+                               t_params->exhaustiveMinimizeRouting);
+  mapper->setNegotiatedRouting(t_params->negotiatedRouting,
+                               t_params->negotiationIterations);
+  mapper->setRepairAttempts(t_params->repairAttempts);
+  mapper->setRefinementTimeLimit(t_params->refinementTimeLimit);
+  mapper->setBinaryConfig(t_params->binaryConfig);
+  return mapper;
+}
+
+/*
+ * Early exit if mapping is not possible when no FU can support certain DFG op. Lists all the missing fus.
+ */
+bool canMap(CGRA* t_cgra, DFG* t_dfg) {
+  std::set<std::string> missing_fus;
+
+  for (auto it = t_dfg->nodes.begin(); it != t_dfg->nodes.end(); ++it) {
+    DFGNode* node = *it;
+    bool nodeSupported = false;
+
+    for (int i = 0; i < t_cgra->getRows() && !nodeSupported; ++i) {
+      for (int j = 0; j < t_cgra->getColumns(); ++j) {
+        CGRANode* fu = t_cgra->nodes[i][j];
+        if (fu && fu->canSupport(node)) {
+          nodeSupported = true;
+          break;
+        }
+      }
+    }
+
+    if (!nodeSupported) {
+      missing_fus.insert(node->getOpcodeName());
+    }
+  }
+
+  if (!missing_fus.empty()) {
+    LOG(LOG_LEVEL_ERROR) << "[canMap] Missing functional units: ";
+    for (const auto& op : missing_fus) {
+      LOG(LOG_LEVEL_ERROR) << op << " ";
+    }
+    LOG(LOG_LEVEL_ERROR) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Maps the DFG onto the CGRA starting from the minimum II, and shows and
+// dumps the mapping. Returns the II of the mapping or -1 on failure.
+int mapDFG(CGRA* t_cgra, Mapper* t_mapper, DFG* t_dfg,
+           MapperParams* t_params) {
+  ScopedTimer timer(STATS_MAP_DFG);
+  bool isStaticElasticCGRA = t_params->isStaticElasticCGRA;
+
+  // Initialize the II.
+  int ResMII = t_mapper->getResMII(t_dfg, t_cgra);
+  LOG(LOG_LEVEL_INFO) << "==================================\n";
+  LOG(LOG_LEVEL_INFO) << "[ResMII: " << ResMII << "]\n";
+  int RecMII = t_mapper->getRecMII(t_dfg);
+  LOG(LOG_LEVEL_INFO) << "==================================\n";
+  LOG(LOG_LEVEL_INFO) << "[RecMII: " << RecMII << "]\n";
+  int II = ResMII;
+  if (II < RecMII)
+    II = RecMII;
+
+  if (t_params->supportDVFS) {
+    t_dfg->initDVFSLatencyMultiple(II, t_params->DVFSIslandDim,
+                                   t_cgra->getFUCount());
+  }
+
+  if (!t_params->doCGRAMapping) {
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    return -1;
+  }
+  if (!canMap(t_cgra, t_dfg)) {
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    LOG(LOG_LEVEL_INFO) << "[Mapping Fail]\n";
+    return -1;
+  }
+
+
+  // The incremental mapping also depends on the referenced mapping, so
+  // it is not cached.
+  MappingCache* cache = NULL;
+  bool cached = false;
+  if (t_params->mappingCacheDir != "" and !t_params->incrementalMapping) {
+    json options = {
+      {"II", II},
+      {"isStaticElasticCGRA", isStaticElasticCGRA},
+      {"ctrlMemConstraint", t_params->ctrlMemConstraint},
+      {"bypassConstraint", t_params->bypassConstraint},
+      {"regConstraint", t_params->regConstraint},
+      {"heuristicMapping", t_params->heuristicMapping},
+      {"IISweepWidth", t_params->IISweepWidth},
+      {"exhaustiveTimeLimit", t_params->exhaustiveTimeLimit},
+      {"exhaustiveExpansionLimit", t_params->exhaustiveExpansionLimit},
+      {"exhaustiveBacktrackLimit", t_params->exhaustiveBacktrackLimit},
+      {"exhaustiveTaskDepth", t_params->exhaustiveTaskDepth},
+      {"exhaustiveMinimizeRouting", t_params->exhaustiveMinimizeRouting},
+      {"negotiatedRouting", t_params->negotiatedRouting},
+      {"negotiationIterations", t_params->negotiationIterations},
+      {"repairAttempts", t_params->repairAttempts},
+      {"refinementTimeLimit", t_params->refinementTimeLimit},
+      {"supportDVFS", t_params->supportDVFS},
+      {"DVFSAwareMapping", t_params->DVFSAwareMapping},
+      {"DVFSIslandDim", t_params->DVFSIslandDim},
+      {"multiCycleStrategy", t_params->multiCycleStrategy}
+    };
+    cache = new MappingCache(t_params->mappingCacheDir, t_cgra, t_dfg,
+                             options.dump());
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    typedef std::chrono::high_resolution_clock Clock;
+    auto t1 = Clock::now();
+    int cachedII = t_mapper->cachedMap(t_cgra, t_dfg, cache,
+                                       isStaticElasticCGRA);
+    auto t2 = Clock::now();
+    int elapsedTime = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1000000;
+    if (cachedII != -1) {
+      cached = true;
+      II = cachedII;
+      LOG(LOG_LEVEL_INFO) << "[Mapping cache hit: " << cache->getKey() << "]\n";
+      LOG(LOG_LEVEL_INFO) <<"Mapping algorithm elapsed time="<<elapsedTime <<"ms"<< '\n';
+    } else {
+      LOG(LOG_LEVEL_INFO) << "[Mapping cache miss: " << cache->getKey() << "]\n";
+    }
+  }
+
+  // Heuristic algorithm (hill climbing) to get a valid mapping within
+  // a acceptable II.
+  bool success = cached;
+  if (!isStaticElasticCGRA and !cached) {
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    typedef std::chrono::high_resolution_clock Clock;
+    auto t1 = Clock::now();
+
+    if (t_params->heuristicMapping) {
+      if (t_params->incrementalMapping) {
+        II = t_mapper->incrementalMap(t_cgra, t_dfg, II);
+        LOG(LOG_LEVEL_INFO) << "[Incremental]\n";
+      } else {
+        LOG(LOG_LEVEL_INFO) << "[heuristic]\n";
+        II = t_mapper->heuristicMap(t_cgra, t_dfg, II, isStaticElasticCGRA);
+        if (II != -1) {
+          t_mapper->refineMapping(t_cgra, t_dfg, II, isStaticElasticCGRA,
+                                  t_params->enablePowerGating);
+        }
+      }
+    } else {
+      LOG(LOG_LEVEL_INFO) << "[exhaustive]\n";
+      II = t_mapper->exhaustiveMap(t_cgra, t_dfg, II, isStaticElasticCGRA);
+    }
+
+    auto t2 = Clock::now();
+    int elapsedTime = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1000000;
+    LOG(LOG_LEVEL_INFO) <<"Mapping algorithm elapsed time="<<elapsedTime <<"ms"<< '\n';
+  }
+
+  // Partially exhaustive search to try to map the DFG onto
+  // the static elastic CGRA.
+
+  if (isStaticElasticCGRA and !success) {
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    LOG(LOG_LEVEL_INFO) << "[exhaustive]\n";
+    II = t_mapper->exhaustiveMap(t_cgra, t_dfg, II, isStaticElasticCGRA);
+  }
+
+  if (cache != NULL and !cached and II != -1) {
+    t_mapper->cacheMapping(t_cgra, t_dfg, cache, II, isStaticElasticCGRA);
+  }
+
+  // Show the mapping and routing results with JSON output.
+  if (II == -1)
+    LOG(LOG_LEVEL_INFO) << "[fail]\n";
+  else {
+    t_mapper->showSchedule(t_cgra, t_dfg, II, isStaticElasticCGRA,
+                           t_params->parameterizableCGRA);
+    LOG(LOG_LEVEL_INFO) << "[Mapping Success]\n";
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    if (t_params->enableExpandableMapping) {
+      LOG(LOG_LEVEL_INFO) << "[ExpandableII: " << t_mapper->getExpandableII(t_dfg, II) << "]\n";
+      LOG(LOG_LEVEL_INFO) << "==================================\n";
+    }
+    LOG(LOG_LEVEL_INFO) << "[Utilization & DVFS stats]\n";
+    t_mapper->showUtilization(t_cgra, t_dfg, II, isStaticElasticCGRA,
+                              t_params->enablePowerGating);
+    LOG(LOG_LEVEL_INFO) << "==================================\n";
+    t_mapper->generateJSON(t_cgra, t_dfg, II, isStaticElasticCGRA);
+    LOG(LOG_LEVEL_INFO) << "[Output Json]\n";
+
+    // save mapping results json file for possible incremental mapping
+    if (!t_params->incrementalMapping) {
+      t_mapper->generateJSON4IncrementalMap(t_cgra, t_dfg);
+      LOG(LOG_LEVEL_INFO) << "[Output Json for Incremental Mapping]\n";
+    }
+  }
+  LOG(LOG_LEVEL_INFO) << "==================================\n";
+  return II;
+}
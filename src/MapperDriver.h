@@ -0,0 +1,70 @@
+/*
+ * ======================================================================
+ * MapperDriver.h
+ * ======================================================================
+ * Mapper driver implementation header file.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef MapperDriver_H
+#define MapperDriver_H
+
+#include "Mapper.h"
+
+// The parameters read from param.json along with their defaults, which are
+// shared by the mapper pass and the standalone mapper.
+struct MapperParams {
+  int rows;
+  int columns;
+  bool targetEntireFunction;
+  bool targetNested;
+  bool doCGRAMapping;
+  bool isStaticElasticCGRA;
+  bool isTrimmedDemo;
+  int ctrlMemConstraint;
+  int bypassConstraint;
+  int regConstraint;
+  bool precisionAware;
+  string vectorizationMode;
+  bool heuristicMapping;
+  bool parameterizableCGRA;
+  bool incrementalMapping;
+  int IISweepWidth;
+  long exhaustiveTimeLimit;
+  long exhaustiveExpansionLimit;
+  long exhaustiveBacktrackLimit;
+  int exhaustiveTaskDepth;
+  bool exhaustiveMinimizeRouting;
+  bool negotiatedRouting;
+  int negotiationIterations;
+  int repairAttempts;
+  long refinementTimeLimit;
+  string mappingCacheDir;
+  bool binaryConfig;
+  bool supportDVFS;
+  bool DVFSAwareMapping;
+  int DVFSIslandDim;
+  bool enablePowerGating;
+  bool enableExpandableMapping;
+  int vectorFactorForIdiv;
+  string multiCycleStrategy;
+  map<string, int>* execLatency;
+  list<string>* pipelinedOpt;
+  list<string>* fusionStrategy;
+  map<string, list<int>*>* additionalFunc;
+  map<string, list<string>*>* fusionPattern;
+  // The target kernel and its loops, which are empty without param.json.
+  string kernel;
+  list<int> targetLoopsID;
+  MapperParams();
+};
+
+bool readParams(string, MapperParams*);
+CGRA* createCGRA(MapperParams*);
+Mapper* createMapper(MapperParams*);
+bool canMap(CGRA*, DFG*);
+int mapDFG(CGRA*, Mapper*, DFG*, MapperParams*);
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * ======================================================================
+ * MapperStats.cpp
+ * ======================================================================
+ * Timer and counter registry of the mapper implementation.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include "MapperStats.h"
+#include "Logger.h"
+#include "json.hpp"
+#include <atomic>
+#include <fstream>
+
+using json = nlohmann::json;
+
+// The phases and counters are updated concurrently by the threads of the
+// mapping, so they are kept in relaxed atomics.
+static atomic<long> phaseCalls[STATS_TIMER_COUNT];
+static atomic<long> phaseNanoseconds[STATS_TIMER_COUNT];
+static atomic<long> counters[STATS_COUNTER_COUNT];
+
+static const char* phaseNames[STATS_TIMER_COUNT] = {
+  "DFG::construct", "DFG::fusion", "DFG::calculateCycles", "DFG::reorder",
+  "mapDFG", "Mapper::constructMRRG", "Mapper::calculateCost",
+  "Mapper::dijkstra_search", "Mapper::schedule", "Mapper::tryToRoute",
+  "generateDot", "generateJSON"
+};
+
+static const char* counterNames[STATS_COUNTER_COUNT] = {
+  "router expansions", "candidate paths", "II attempts", "backtracks",
+  "MRRG bytes"
+};
+
+ScopedTimer::ScopedTimer(int t_phase) {
+  m_phase = t_phase;
+  m_start = chrono::steady_clock::now();
+}
+
+ScopedTimer::~ScopedTimer() {
+  long elapsed = chrono::duration_cast<chrono::nanoseconds>(
+      chrono::steady_clock::now() - m_start).count();
+  phaseCalls[m_phase].fetch_add(1, memory_order_relaxed);
+  phaseNanoseconds[m_phase].fetch_add(elapsed, memory_order_relaxed);
+}
+
+void addStatsCount(int t_counter, long t_value) {
+  counters[t_counter].fetch_add(t_value, memory_order_relaxed);
+}
+
+void resetStats() {
+  for (int i=0; i<STATS_TIMER_COUNT; ++i) {
+    phaseCalls[i] = 0;
+    phaseNanoseconds[i] = 0;
+  }
+  for (int i=0; i<STATS_COUNTER_COUNT; ++i) {
+    counters[i] = 0;
+  }
+}
+
+// Writes the phases (i.e., their calls and time in ms) and the counters
+// along with the kernel and its II (-1 on failure) into the given file.
+bool writeStats(string t_fileName, string t_kernel, int t_II) {
+  json stats;
+  stats["kernel"] = t_kernel;
+  stats["II"] = t_II;
+  stats["phases"] = json::object();
+  for (int i=0; i<STATS_TIMER_COUNT; ++i) {
+    stats["phases"][phaseNames[i]] = {
+      {"calls", phaseCalls[i].load()},
+      {"ms", phaseNanoseconds[i].load() / 1000000.0}
+    };
+  }
+  stats["counters"] = json::object();
+  for (int i=0; i<STATS_COUNTER_COUNT; ++i) {
+    stats["counters"][counterNames[i]] = counters[i].load();
+  }
+  ofstream statsFile(t_fileName);
+  if (!statsFile.good()) {
+    LOG(LOG_LEVEL_ERROR)<<"Cannot write "<<t_fileName<<endl;
+    return false;
+  }
+  statsFile<<stats.dump(2)<<"\n";
+  return true;
+}
@@ -0,0 +1,60 @@
+/*
+ * ======================================================================
+ * MapperStats.h
+ * ======================================================================
+ * Timer and counter registry of the mapper implementation header file.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef MapperStats_H
+#define MapperStats_H
+
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+// Phases timed by the scoped timers.
+#define STATS_DFG_CONSTRUCT       0 // DFG::construct() or reading dfg.json
+#define STATS_DFG_FUSION          1 // combine*() and tuneFor*()
+#define STATS_DFG_CYCLES          2 // DFG::calculateCycles()
+#define STATS_DFG_REORDER         3 // DFG::reorder*()
+#define STATS_MAP_DFG             4 // The whole mapDFG()
+#define STATS_CONSTRUCT_MRRG      5 // Mapper::constructMRRG() per II
+#define STATS_CALCULATE_COST      6 // Mapper::calculateCost() per candidate
+#define STATS_DIJKSTRA            7 // Mapper::dijkstra_search()
+#define STATS_SCHEDULE            8 // Mapper::schedule()
+#define STATS_TRY_TO_ROUTE        9 // Mapper::tryToRoute()
+#define STATS_WRITE_DOT          10 // DFG::generateDot()
+#define STATS_WRITE_JSON         11 // The dfg.json and config.json writers
+#define STATS_TIMER_COUNT        12
+
+// Counters.
+#define STATS_ROUTER_EXPANSIONS   0 // Tiles settled by the router
+#define STATS_CANDIDATE_PATHS     1 // Candidate paths scored for placement
+#define STATS_II_ATTEMPTS         2 // Mapping attempts over all the IIs
+#define STATS_BACKTRACKS          3 // Backtracks of the exhaustive search
+#define STATS_MRRG_BYTES          4 // Bytes allocated for the MRRGs
+#define STATS_COUNTER_COUNT       5
+
+// Accumulates the wall-clock time and the call count of a phase from its
+// construction to its destruction. The nested phases (e.g., dijkstra in
+// calculateCost) are included in the outer ones, and the phases running
+// on several threads sum up the time of all of them.
+class ScopedTimer {
+  private:
+    int m_phase;
+    chrono::steady_clock::time_point m_start;
+
+  public:
+    ScopedTimer(int);
+    ~ScopedTimer();
+};
+
+void addStatsCount(int, long);
+void resetStats();
+bool writeStats(string, string, int);
+
+#endif
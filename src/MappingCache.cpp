@@ -0,0 +1,139 @@
+/*
+ * ======================================================================
+ * MappingCache.cpp
+ * ======================================================================
+ * On-disk mapping cache implementation.
+ *
+ * Author : agent
+ *   Date : Oct 18, 2026
+ */
+
+#include "MappingCache.h"
+#include "Logger.h"
+#include "DFG.h"
+#include "CGRA.h"
+#include "json.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+// Describes everything the mapping depends on. The tiles are described by
+// the DFG nodes they support rather than by their functional units, which
+// also covers the fused and the vectorized DFG nodes.
+MappingCache::MappingCache(string t_directory, CGRA* t_cgra, DFG* t_dfg,
+                           string t_options) {
+  m_directory = t_directory;
+  ostringstream signature;
+  signature<<"mapping cache v1\n";
+  signature<<"options "<<t_options<<"\n";
+  signature<<"dfg "<<t_dfg->nodes.size()<<"\n";
+  for (DFGNode* dfgNode: t_dfg->nodes) {
+    signature<<"node "<<dfgNode->getID()<<" "<<dfgNode->getOpcodeName()
+             <<" latency "<<dfgNode->getExecLatency(
+                 dfgNode->getDVFSLatencyMultiple())
+             <<" dvfs "<<dfgNode->getDVFSLatencyMultiple()
+             <<" pipelinable "<<dfgNode->isPipelinable()
+             <<" critical "<<dfgNode->isCritical()<<" cycles";
+    for (int cycleID: *(dfgNode->getCycleIDs())) {
+      signature<<" "<<cycleID;
+    }
+    signature<<" succs";
+    for (DFGNode* succNode: *(dfgNode->getSuccNodes())) {
+      signature<<" "<<succNode->getID();
+    }
+    signature<<"\n";
+  }
+  signature<<"cgra "<<t_cgra->getRows()<<"x"<<t_cgra->getColumns()<<"\n";
+  for (int i=0; i<t_cgra->getFUCount(); ++i) {
+    CGRANode* tile = t_cgra->getNode(i);
+    signature<<"tile "<<tile->getID()<<" ("<<tile->getX()<<","<<tile->getY()
+             <<") disabled "<<tile->isDisabled()
+             <<" dvfs "<<tile->isDVFSEnabled()<<" "<<tile->getDVFSIslandID()
+             <<" "<<tile->getDVFSLatencyMultiple()
+             <<" multipleOps "<<tile->canMultipleOps()<<" supports ";
+    for (DFGNode* dfgNode: t_dfg->nodes) {
+      signature<<tile->canSupport(dfgNode);
+    }
+    signature<<"\n";
+  }
+  for (int i=0; i<t_cgra->getLinkCount(); ++i) {
+    CGRALink* link = t_cgra->links[i];
+    signature<<"link "<<link->getID()<<" "<<link->getSrc()->getID()<<" -> "
+             <<link->getDst()->getID()<<" bypass "
+             <<link->getBypassConstraint()<<"\n";
+  }
+  m_signature = signature.str();
+
+  // 64-bit FNV-1a.
+  unsigned long long hash = 14695981039346656037ULL;
+  for (unsigned char c: m_signature) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  ostringstream key;
+  key<<hex<<setw(16)<<setfill('0')<<hash;
+  m_key = key.str();
+}
+
+string MappingCache::getKey() {
+  return m_key;
+}
+
+string MappingCache::getPath() {
+  return m_directory + "/" + m_key + ".json";
+}
+
+// Reads the II, the tile IDs and the cycles of the cached mapping. Returns
+// false if there is no readable entry for exactly the same description.
+bool MappingCache::load(int* t_II, vector<int>* t_tiles,
+                        vector<int>* t_cycles) {
+  ifstream entryFile(getPath());
+  if (!entryFile.good())
+    return false;
+  json entry;
+  try {
+    entryFile >> entry;
+    if (entry.at("signature").get<string>() != m_signature) {
+      LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] mapping cache collision on key "<<m_key<<"\n";
+      return false;
+    }
+    *t_II = entry.at("II");
+    t_tiles->clear();
+    t_cycles->clear();
+    for (json& dfgNode: entry.at("mapping")) {
+      t_tiles->push_back(dfgNode.at("tile"));
+      t_cycles->push_back(dfgNode.at("cycle"));
+    }
+  } catch (json::exception& e) {
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] invalid mapping cache entry "<<getPath()<<": "<<e.what()<<"\n";
+    return false;
+  }
+  return true;
+}
+
+// Writes the entry into a temporary file that is then renamed, so that the
+// concurrent runs never read a partially written entry.
+void MappingCache::store(int t_II, vector<int>* t_tiles,
+                         vector<int>* t_cycles) {
+  mkdir(m_directory.c_str(), 0755);
+  json entry;
+  entry["signature"] = m_signature;
+  entry["II"] = t_II;
+  entry["mapping"] = json::array();
+  for (int i=0; i<t_tiles->size(); ++i) {
+    entry["mapping"].push_back({{"tile", (*t_tiles)[i]},
+                                {"cycle", (*t_cycles)[i]}});
+  }
+  string tempPath = getPath() + ".tmp" + to_string(getpid());
+  ofstream entryFile(tempPath, ios::out);
+  entryFile<<entry.dump(2)<<endl;
+  entryFile.close();
+  if (!entryFile or rename(tempPath.c_str(), getPath().c_str()) != 0) {
+    LOG(LOG_LEVEL_DEBUG)<<"[DEBUG] cannot write mapping cache entry "<<getPath()<<"\n";
+    remove(tempPath.c_str());
+  }
+}
@@ -0,0 +1,41 @@
+/*
+ * ======================================================================
+ * MappingCache.h
+ * ======================================================================
+ * On-disk mapping cache implementation header file.
+ *
+ * Author : agent
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef MappingCache_H
+#define MappingCache_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class CGRA;
+class DFG;
+
+// Content-addressed cache of the mappings on disk. The key hashes the
+// canonical description of the fused DFG, the CGRA and the mapper options,
+// and the entry stores the II along with the tile and the cycle of each
+// DFG node in the order of the DFG nodes. The description is stored with
+// the entry, so a hash collision is a miss rather than a wrong mapping.
+class MappingCache {
+  private:
+    string m_directory;
+    string m_signature;
+    string m_key;
+    string getPath();
+
+  public:
+    MappingCache(string, CGRA*, DFG*, string);
+    string getKey();
+    bool load(int*, vector<int>*, vector<int>*);
+    void store(int, vector<int>*, vector<int>*);
+};
+
+#endif
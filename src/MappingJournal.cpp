@@ -0,0 +1,71 @@
+/*
+ * ======================================================================
+ * MappingJournal.cpp
+ * ======================================================================
+ * Undo journal of the MRRG implementation.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include "MappingJournal.h"
+#include "CGRANode.h"
+#include <assert.h>
+#include <stdint.h>
+
+#define JOURNAL_INT       0 // An int is overwritten
+#define JOURNAL_WORD      1 // A word of a bit-plane is overwritten
+#define JOURNAL_DFG_NODE  2 // A DFG node slot is overwritten
+#define JOURNAL_OCCUPANCY 3 // An occupancy is appended
+
+void MappingJournal::clear() {
+  m_entries.clear();
+}
+
+int MappingJournal::getMark() {
+  return m_entries.size();
+}
+
+void MappingJournal::recordInt(int* t_address) {
+  Entry entry = {JOURNAL_INT, t_address, (unsigned long long)*t_address};
+  m_entries.push_back(entry);
+}
+
+void MappingJournal::recordWord(unsigned long long* t_address) {
+  Entry entry = {JOURNAL_WORD, t_address, *t_address};
+  m_entries.push_back(entry);
+}
+
+void MappingJournal::recordDFGNode(DFGNode** t_address) {
+  Entry entry = {JOURNAL_DFG_NODE, t_address,
+                 (unsigned long long)(uintptr_t)*t_address};
+  m_entries.push_back(entry);
+}
+
+void MappingJournal::recordOccupancy(vector<ModuloOccupancy>* t_occupancies) {
+  Entry entry = {JOURNAL_OCCUPANCY, t_occupancies, 0};
+  m_entries.push_back(entry);
+}
+
+// Undoes the changes in the reverse order until the given mark.
+void MappingJournal::rollback(int t_mark) {
+  assert(t_mark <= m_entries.size());
+  while (m_entries.size() > t_mark) {
+    Entry& entry = m_entries.back();
+    switch (entry.kind) {
+      case JOURNAL_INT:
+        *(int*)entry.address = (int)entry.value;
+        break;
+      case JOURNAL_WORD:
+        *(unsigned long long*)entry.address = entry.value;
+        break;
+      case JOURNAL_DFG_NODE:
+        *(DFGNode**)entry.address = (DFGNode*)(uintptr_t)entry.value;
+        break;
+      case JOURNAL_OCCUPANCY:
+        ((vector<ModuloOccupancy>*)entry.address)->pop_back();
+        break;
+    }
+    m_entries.pop_back();
+  }
+}
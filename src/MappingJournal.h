@@ -0,0 +1,43 @@
+/*
+ * ======================================================================
+ * MappingJournal.h
+ * ======================================================================
+ * Undo journal of the MRRG implementation header file.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef MappingJournal_H
+#define MappingJournal_H
+
+#include <vector>
+
+using namespace std;
+
+class DFGNode;
+struct ModuloOccupancy;
+
+// Records the old values of the MRRG states before they are changed by
+// the mapping, so that the MRRG can be rolled back to an earlier mark by
+// only undoing the changes made since then.
+class MappingJournal {
+  private:
+    struct Entry {
+      int kind;
+      void* address;
+      unsigned long long value;
+    };
+    vector<Entry> m_entries;
+
+  public:
+    void clear();
+    int getMark();
+    void recordInt(int*);
+    void recordWord(unsigned long long*);
+    void recordDFGNode(DFGNode**);
+    void recordOccupancy(vector<ModuloOccupancy>*);
+    void rollback(int);
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * ======================================================================
+ * MappingPath.cpp
+ * ======================================================================
+ * Candidate mapping path implementation.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include "MappingPath.h"
+#include "CGRA.h"
+#include <algorithm>
+#include <assert.h>
+
+// Keeps the allocated hops so that the path can be reused without
+// touching the heap again.
+void MappingPath::clear() {
+  m_hops.clear();
+}
+
+void MappingPath::addHop(CGRANode* t_tile, int t_cycle) {
+  PathHop hop = {t_tile, t_cycle};
+  m_hops.push_back(hop);
+}
+
+// The path is collected backwards from the target tile.
+void MappingPath::reverse() {
+  std::reverse(m_hops.begin(), m_hops.end());
+}
+
+void MappingPath::swap(MappingPath& t_path) {
+  m_hops.swap(t_path.m_hops);
+}
+
+// Moves the hops onto the tiles with the same IDs on another copy of
+// the CGRA.
+void MappingPath::rebase(CGRA* t_cgra) {
+  for (PathHop& hop: m_hops) {
+    hop.tile = t_cgra->getNode(hop.tile->getID());
+  }
+}
+
+int MappingPath::size() {
+  return m_hops.size();
+}
+
+PathHop& MappingPath::getHop(int t_index) {
+  return m_hops[t_index];
+}
+
+PathHop& MappingPath::getSource() {
+  assert(m_hops.size() != 0);
+  return m_hops.front();
+}
+
+PathHop& MappingPath::getTarget() {
+  assert(m_hops.size() != 0);
+  return m_hops.back();
+}
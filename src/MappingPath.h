@@ -0,0 +1,47 @@
+/*
+ * ======================================================================
+ * MappingPath.h
+ * ======================================================================
+ * Candidate mapping path implementation header file.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef MappingPath_H
+#define MappingPath_H
+
+#include "CGRANode.h"
+#include <vector>
+
+using namespace std;
+
+class CGRA;
+
+// A tile on the path along with the cycle at which the data arrives.
+struct PathHop {
+  CGRANode* tile;
+  int cycle;
+};
+
+// The path delivering the data from a mapped predecessor onto the target
+// tile of a DFG node. The hops are kept in a flat array ordered by cycle,
+// i.e., from the source tile to the target tile. A DFG node without any
+// mapped predecessor only has the target hop.
+class MappingPath {
+  private:
+    vector<PathHop> m_hops;
+
+  public:
+    void clear();
+    void addHop(CGRANode*, int);
+    void reverse();
+    void swap(MappingPath&);
+    void rebase(CGRA*);
+    int size();
+    PathHop& getHop(int);
+    PathHop& getSource();
+    PathHop& getTarget();
+};
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ * ======================================================================
+ * Router.cpp
+ * ======================================================================
+ * Time-expanded router implementation.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include "Router.h"
+#include "CGRA.h"
+#include "MapperStats.h"
+#include <assert.h>
+#include <cfloat>
+
+Router::Router(CGRA* t_cgra) {
+  m_cgra = t_cgra;
+  m_nodeCount = t_cgra->getRows() * t_cgra->getColumns();
+  m_maxMappingCycle = 0;
+  m_history = NULL;
+  m_presentFactor = 0;
+  m_nodes.assign(m_nodeCount, NULL);
+  for (int i=0; i<t_cgra->getRows(); ++i) {
+    for (int j=0; j<t_cgra->getColumns(); ++j) {
+      CGRANode* node = t_cgra->nodes[i][j];
+      assert(node->getID() == i * t_cgra->getColumns() + j);
+      m_nodes[node->getID()] = node;
+    }
+  }
+
+  // The connectivity never changes after the CGRA is constructed, so the
+  // neighbors and the links towards them are resolved only once.
+  m_neighbors.resize(m_nodeCount);
+  m_neighborLinks.resize(m_nodeCount);
+  for (CGRANode* node: m_nodes) {
+    for (CGRANode* neighbor: *(node->getNeighbors())) {
+      m_neighbors[node->getID()].push_back(neighbor->getID());
+      m_neighborLinks[node->getID()].push_back(node->getOutLink(neighbor));
+    }
+  }
+
+  m_distance.resize(m_nodeCount);
+  m_timing.resize(m_nodeCount);
+  m_previous.resize(m_nodeCount);
+  m_visited.resize(m_nodeCount);
+  m_heapPos.resize(m_nodeCount);
+  m_heap.reserve(m_nodeCount);
+}
+
+CGRA* Router::getCGRA() {
+  return m_cgra;
+}
+
+int Router::getNodeCount() {
+  return m_nodeCount;
+}
+
+void Router::setCongestion(vector<float>* t_history, float t_presentFactor) {
+  m_history = t_history;
+  m_presentFactor = t_presentFactor;
+}
+
+// The cost of delivering through the link at the given cycle after
+// waiting for it since the arrival, i.e., the waiting cycles plus one
+// cycle for the delivery, plus the history cost of its modulo slot. The
+// cost of an overused slot is scaled by the present factor.
+float Router::getHopCost(CGRALink* t_link, int t_arrival, int t_cycle,
+    int t_II, bool t_isOverused) {
+  float cost = (t_cycle - t_arrival) + 1;
+  if (m_history != NULL) {
+    int slot = (t_cycle%t_II + t_II) % t_II;
+    cost += (*m_history)[t_link->getID()*t_II + slot];
+  }
+  if (t_isOverused)
+    cost *= 1 + m_presentFactor;
+  return cost;
+}
+
+// Whether the link can be occupied at the given cycle at the price of the
+// overuse, i.e., only the data of other DFG nodes blocks it, which is
+// only allowed with a present factor.
+bool Router::canOveruse(DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode,
+    CGRALink* t_link, int t_cycle, int t_II) {
+  return m_presentFactor > 0 and t_link->getBlockingDFGNodes(
+      t_srcDFGNode, t_srcCGRANode, t_cycle, t_II, NULL) > 0;
+}
+
+// Resets the search states. The data produced by the source DFG node
+// is available on each tile once the execution latency of that tile
+// has elapsed.
+void Router::init(DFGNode* t_srcDFGNode, int t_srcTiming,
+    int t_maxMappingCycle) {
+  m_maxMappingCycle = t_maxMappingCycle;
+  for (int id=0; id<m_nodeCount; ++id) {
+    // Without congestion the distance never exceeds the cycles, so the
+    // maximum mapping cycle bounds the search as well.
+    m_distance[id] = m_history == NULL ? m_maxMappingCycle : FLT_MAX;
+    m_timing[id] = t_srcTiming +
+        t_srcDFGNode->getExecLatency(m_nodes[id]->getDVFSLatencyMultiple()) - 1;
+    m_previous[id] = -1;
+    m_visited[id] = false;
+    m_heapPos[id] = -1;
+  }
+  m_heap.clear();
+}
+
+// Searches the shortest path from the source tile until the destination
+// tile is settled. The cost of a hop is the number of cycles waiting for
+// an available link plus one cycle for the delivery.
+void Router::search(DFGNode* t_srcDFGNode, CGRANode* t_srcCGRANode,
+    CGRANode* t_dstCGRANode, int t_II) {
+  int srcID = t_srcCGRANode->getID();
+  int dstID = t_dstCGRANode->getID();
+  m_distance[srcID] = 0;
+  push(srcID);
+  long expansions = 0;
+  while (m_heap.size() != 0) {
+    int minID = pop();
+    m_visited[minID] = true;
+    ++expansions;
+    // found the target point in the shortest path
+    if (minID == dstID) {
+      break;
+    }
+    vector<int>& neighbors = m_neighbors[minID];
+    vector<CGRALink*>& links = m_neighborLinks[minID];
+    for (int n=0; n<neighbors.size(); ++n) {
+      int neighborID = neighbors[n];
+      // A settled tile can never be improved as every hop costs at
+      // least one cycle.
+      if (m_visited[neighborID]) {
+        continue;
+      }
+      CGRALink* currentLink = links[n];
+      int arrival = m_timing[minID];
+      int cycle = arrival;
+      // The first slot that can be overused before the first available
+      // one, if any, competes with it.
+      int overusedCycle = -1;
+      while (1) {
+        // TODO: should also consider the cost of the register file
+        if (currentLink->canOccupy(t_srcDFGNode, t_srcCGRANode, cycle, t_II)) {
+          break;
+        }
+        if (overusedCycle == -1 and canOveruse(t_srcDFGNode, t_srcCGRANode,
+                                              currentLink, cycle, t_II))
+          overusedCycle = cycle;
+        ++cycle;
+        if (cycle > m_maxMappingCycle)
+          break;
+      }
+      if (cycle > m_maxMappingCycle and overusedCycle == -1)
+        continue;
+      // rough estimate the cost based on the suspend cycle
+      float cost = FLT_MAX;
+      if (cycle <= m_maxMappingCycle)
+        cost = m_distance[minID] +
+               getHopCost(currentLink, arrival, cycle, t_II, false);
+      if (overusedCycle != -1) {
+        float overusedCost = m_distance[minID] +
+            getHopCost(currentLink, arrival, overusedCycle, t_II, true);
+        if (overusedCost < cost) {
+          cost = overusedCost;
+          cycle = overusedCycle;
+        }
+      }
+      if (cost < m_distance[neighborID]) {
+        m_distance[neighborID] = cost;
+        m_timing[neighborID] = cycle + 1;
+        m_previous[neighborID] = minID;
+        push(neighborID);
+      }
+    }
+  }
+  addStatsCount(STATS_ROUTER_EXPANSIONS, expansions);
+}
+
+float Router::getDistance(CGRANode* t_node) {
+  return m_distance[t_node->getID()];
+}
+
+int Router::getTiming(CGRANode* t_node) {
+  return m_timing[t_node->getID()];
+}
+
+void Router::setTiming(CGRANode* t_node, int t_timing) {
+  m_timing[t_node->getID()] = t_timing;
+}
+
+CGRANode* Router::getPrevious(CGRANode* t_node) {
+  int previousID = m_previous[t_node->getID()];
+  if (previousID == -1)
+    return NULL;
+  return m_nodes[previousID];
+}
+
+// Collects the shortest path from the source tile to the destination tile
+// found by the last search, which fails if the destination is unreachable.
+bool Router::buildPath(CGRANode* t_srcCGRANode, CGRANode* t_dstCGRANode,
+    MappingPath* t_path) {
+  t_path->clear();
+  if (getPrevious(t_dstCGRANode) == NULL and t_dstCGRANode != t_srcCGRANode)
+    return false;
+  for (int id=t_dstCGRANode->getID(); id!=-1; id=m_previous[id]) {
+    t_path->addHop(m_nodes[id], m_timing[id]);
+  }
+  t_path->reverse();
+  return true;
+}
+
+// Ties on the distance are broken by the tile ID, which matches the
+// row-major order of the tiles.
+bool Router::isPrior(int t_a, int t_b) {
+  if (m_distance[t_a] != m_distance[t_b])
+    return m_distance[t_a] < m_distance[t_b];
+  return t_a < t_b;
+}
+
+void Router::siftUp(int t_pos) {
+  int id = m_heap[t_pos];
+  while (t_pos > 0) {
+    int parent = (t_pos - 1) / 2;
+    if (!isPrior(id, m_heap[parent]))
+      break;
+    m_heap[t_pos] = m_heap[parent];
+    m_heapPos[m_heap[t_pos]] = t_pos;
+    t_pos = parent;
+  }
+  m_heap[t_pos] = id;
+  m_heapPos[id] = t_pos;
+}
+
+void Router::siftDown(int t_pos) {
+  int id = m_heap[t_pos];
+  int size = m_heap.size();
+  while (2 * t_pos + 1 < size) {
+    int child = 2 * t_pos + 1;
+    if (child + 1 < size and isPrior(m_heap[child + 1], m_heap[child]))
+      ++child;
+    if (!isPrior(m_heap[child], id))
+      break;
+    m_heap[t_pos] = m_heap[child];
+    m_heapPos[m_heap[t_pos]] = t_pos;
+    t_pos = child;
+  }
+  m_heap[t_pos] = id;
+  m_heapPos[id] = t_pos;
+}
+
+// Inserts the tile or, if it is already in the heap, restores the heap
+// order after its distance is decreased.
+void Router::push(int t_id) {
+  if (m_heapPos[t_id] == -1) {
+    m_heap.push_back(t_id);
+    m_heapPos[t_id] = m_heap.size() - 1;
+  }
+  siftUp(m_heapPos[t_id]);
+}
+
+int Router::pop() {
+  int top = m_heap[0];
+  m_heapPos[top] = -1;
+  int last = m_heap.back();
+  m_heap.pop_back();
+  if (m_heap.size() != 0) {
+    m_heap[0] = last;
+    m_heapPos[last] = 0;
+    siftDown(0);
+  }
+  return top;
+}
@@ -0,0 +1,82 @@
+/*
+ * ======================================================================
+ * Router.h
+ * ======================================================================
+ * Time-expanded router shared by the placement cost estimation and
+ * the data routing of the mapper.
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#ifndef Router_H
+#define Router_H
+
+#include "CGRANode.h"
+#include "CGRALink.h"
+#include "DFGNode.h"
+#include "MappingPath.h"
+#include <vector>
+
+using namespace std;
+
+class CGRA;
+
+// Dijkstra search over the tiles of the CGRA, in which the timing of
+// each tile is the cycle the data arrives at it. Tiles are indexed by
+// their dense IDs (row-major) so that all the per-search states are
+// kept in flat arrays that are reused across searches. The frontier is
+// an indexed binary heap ordered by (distance, tile ID), which pops
+// the tiles in exactly the same order as the previous linear scan over
+// the row-major search pool did.
+//
+// Optionally, each hop also costs the congestion of its link (see
+// setCongestion()), in which case the search prefers the less congested
+// links over the earlier arrival. With a present factor, a slot blocked by
+// the data of other DFG nodes can be overused at a price, which is how
+// the negotiated routing finds the contested slots.
+class Router {
+  private:
+    CGRA* m_cgra;
+    int m_nodeCount;
+    int m_maxMappingCycle;
+    vector<CGRANode*> m_nodes;
+    vector<vector<int>> m_neighbors;
+    vector<vector<CGRALink*>> m_neighborLinks;
+    // The history cost of each modulo slot of each link (indexed by the
+    // link ID and then the slot), which is ignored if NULL, and the price
+    // of the overuse of a slot, where 0 disallows any overuse.
+    vector<float>* m_history;
+    float m_presentFactor;
+    float getHopCost(CGRALink*, int, int, int, bool);
+    bool canOveruse(DFGNode*, CGRANode*, CGRALink*, int, int);
+
+    // Scratch buffers reused by every search.
+    vector<float> m_distance;
+    vector<int> m_timing;
+    vector<int> m_previous;
+    vector<bool> m_visited;
+    vector<int> m_heap;
+    vector<int> m_heapPos;
+
+    bool isPrior(int, int);
+    void siftUp(int);
+    void siftDown(int);
+    void push(int);
+    int pop();
+
+  public:
+    Router(CGRA*);
+    CGRA* getCGRA();
+    int getNodeCount();
+    void setCongestion(vector<float>*, float);
+    void init(DFGNode*, int, int);
+    void search(DFGNode*, CGRANode*, CGRANode*, int);
+    float getDistance(CGRANode*);
+    int getTiming(CGRANode*);
+    void setTiming(CGRANode*, int);
+    CGRANode* getPrevious(CGRANode*);
+    bool buildPath(CGRANode*, CGRANode*, MappingPath*);
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * ======================================================================
+ * configTool.cpp
+ * ======================================================================
+ * Converter between config.json and config.bin (see ConfigBinary.h),
+ * which reproduces either file byte by byte from the other one.
+ *
+ * Usage: configTool bin2json <config.bin> [config.json]
+ *        configTool json2bin <config.json> <config.bin> <rows> <columns> <II>
+ *
+ * Author : Cheng Tan
+ *   Date : Oct 18, 2026
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "ConfigBinary.h"
+#include "json.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+// Writes the records in the layout of Mapper::generateJSON().
+static void writeJSON(ConfigBinaryReader* t_reader, ostream& t_jsonFile) {
+  t_jsonFile<<"[\n";
+  for (int i=0; i<t_reader->getRecordCount(); ++i) {
+    ConfigBinaryRecord* record = t_reader->getRecord(i);
+    if (i > 0)
+      t_jsonFile<<",\n";
+    t_jsonFile<<"  {\n";
+    t_jsonFile<<"    \"x\"           : "<<record->x<<",\n";
+    t_jsonFile<<"    \"y\"           : "<<record->y<<",\n";
+    t_jsonFile<<"    \"cycle\"       : "<<record->cycle<<",\n";
+    t_jsonFile<<"    \"opt\"         : \""<<t_reader->getOpcode(record->opcode)<<"\",\n";
+    t_jsonFile<<"    \"predicate\"   : "<<(int)record->predicate<<",\n";
+    if (record->predicateInCount > 0) {
+      t_jsonFile<<"    \"predicate_in\": [";
+      for (int p=0; p<record->predicateInCount; ++p) {
+        if (p > 0)
+          t_jsonFile<<",";
+        t_jsonFile<<(int)record->predicateIn[p];
+      }
+      t_jsonFile<<"],\n";
+    }
+    for (int o=0; o<CONFIG_BINARY_OUTPUTS; ++o) {
+      t_jsonFile<<"    \"out_"<<o<<"\"       : \"";
+      if (record->out[o] == CONFIG_BINARY_NONE)
+        t_jsonFile<<"none";
+      else
+        t_jsonFile<<(int)record->out[o];
+      t_jsonFile<<"\"";
+      if (o < CONFIG_BINARY_OUTPUTS-1)
+        t_jsonFile<<",\n";
+      else
+        t_jsonFile<<"\n";
+    }
+    t_jsonFile<<"  }";
+  }
+  t_jsonFile<<"\n]\n";
+}
+
+static int bin2json(string t_binaryFileName, string t_jsonFileName) {
+  ConfigBinaryReader reader;
+  if (!reader.open(t_binaryFileName)) {
+    cerr<<reader.getError()<<endl;
+    return 1;
+  }
+  ostringstream jsonFile;
+  writeJSON(&reader, jsonFile);
+  if (t_jsonFileName == "") {
+    cout<<jsonFile.str();
+  } else {
+    ofstream(t_jsonFileName)<<jsonFile.str();
+  }
+  return 0;
+}
+
+static int json2bin(string t_jsonFileName, string t_binaryFileName,
+                    int t_rows, int t_columns, int t_II) {
+  ifstream jsonFile(t_jsonFileName);
+  if (!jsonFile.good()) {
+    cerr<<"cannot open "<<t_jsonFileName<<endl;
+    return 1;
+  }
+  json entries;
+  jsonFile >> entries;
+  ConfigBinaryWriter writer;
+  for (json& entry: entries) {
+    vector<int> predicateIn;
+    if (entry.find("predicate_in") != entry.end()) {
+      for (int port: entry["predicate_in"]) {
+        predicateIn.push_back(port);
+      }
+    }
+    string out[CONFIG_BINARY_OUTPUTS];
+    for (int o=0; o<CONFIG_BINARY_OUTPUTS; ++o) {
+      out[o] = entry["out_" + to_string(o)];
+    }
+    int predicate = entry["predicate"];
+    writer.addRecord(entry["x"], entry["y"], entry["cycle"], entry["opt"],
+                     predicate != 0, predicateIn, out);
+  }
+  if (!writer.write(t_binaryFileName, t_rows, t_columns, t_II)) {
+    cerr<<writer.getError()<<endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  string mode = argc > 1 ? argv[1] : "";
+  if (mode == "bin2json" and (argc == 3 or argc == 4)) {
+    return bin2json(argv[2], argc == 4 ? argv[3] : "");
+  }
+  if (mode == "json2bin" and argc == 7) {
+    return json2bin(argv[2], argv[3], stoi(argv[4]), stoi(argv[5]),
+                    stoi(argv[6]));
+  }
+  cerr<<"Usage: configTool bin2json <config.bin> [config.json]"<<endl;
+  cerr<<"       configTool json2bin <config.json> <config.bin> <rows> <columns> <II>"<<endl;
+  return 1;
+}
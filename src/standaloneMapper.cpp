@@ -0,0 +1,49 @@
+/*
+ * ======================================================================
+ * standaloneMapper.cpp
+ * ======================================================================
+ * Standalone mapper implementation, which maps the dfg.json generated by
+ * the mapper pass without LLVM opt, e.g., for the sweeps of the mapper
+ * parameters and for benchmarking the mapper in isolation.
+ *
+ * Usage: mapper [dfg.json] [param.json]
+ *
+ * Author : agent
+ *   Date : Oct 18, 2026
+ */
+
+#include <fstream>
+#include <iostream>
+#include "MapperDriver.h"
+#include "Logger.h"
+#include "MapperStats.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  bufferLogging();
+  string dfgFileName = argc > 1 ? argv[1] : "./dfg.json";
+  string paramFileName = argc > 2 ? argv[2] : "./param.json";
+
+  MapperParams* params = new MapperParams();
+  readParams(paramFileName, params);
+  if (!ifstream(dfgFileName).good()) {
+    LOG(LOG_LEVEL_ERROR)<<"\033[0;31mPlease provide a valid <"<<dfgFileName<<">.\033[0m"<<endl;
+    return 1;
+  }
+  LOG(LOG_LEVEL_INFO) << "==================================\n";
+  LOG(LOG_LEVEL_INFO) << "[read DFG from " << dfgFileName << "]\n";
+  DFG* dfg = new DFG(dfgFileName, params->precisionAware,
+                     params->supportDVFS, params->DVFSAwareMapping);
+  CGRA* cgra = createCGRA(params);
+  Mapper* mapper = createMapper(params);
+
+  // Show the count of different opcodes (IRs).
+  LOG(LOG_LEVEL_INFO) << "==================================\n";
+  LOG(LOG_LEVEL_INFO) << "[show opcode count]\n";
+  dfg->showOpcodeDistribution();
+
+  int II = mapDFG(cgra, mapper, dfg, params);
+  writeStats("mapper_stats.json", params->kernel, II);
+  return II == -1 ? 1 : 0;
+}
@@ -0,0 +1,2 @@
+rm -f config.json config.bin
+opt-12 -load ../../build/src/libmapperPass.so -mapperPass kernel_unroll.bc | tee trace.log
@@ -0,0 +1,11 @@
+II=$(grep -ao '\[Mapping II: [0-9]*\]' trace.log | head -1 | grep -o '[0-9]*')
+rm -f roundtrip.json roundtrip.bin
+../../build/src/configTool bin2json config.bin roundtrip.json
+../../build/src/configTool json2bin config.json roundtrip.bin 4 4 $II
+echo "II: $II"
+if [ -n "$II" ] && cmp config.json roundtrip.json && cmp config.bin roundtrip.bin; then
+    echo "Binary Config Test Pass!"
+else
+    echo "Binary Config Test Fail!"
+    exit 1
+fi
@@ -0,0 +1,36 @@
+# Shared by the tests that map kernel() of test/kernel.cpp, sourced from
+# their compile.sh and run.sh. The tools can be overridden, e.g.,
+#   OPT="opt-14 -enable-new-pm=0" LLVM_AS=llvm-as-14 sh run.sh
+# When clang is not available, kernel.bc is assembled from kernel.ll.
+
+CLANG=${CLANG:-clang-12}
+OPT=${OPT:-opt-12}
+LLVM_AS=${LLVM_AS:-llvm-as-12}
+MAPPER_PASS=${MAPPER_PASS:-../../build/src/libmapperPass.so}
+MAPPER=${MAPPER:-../../build/src/mapper}
+
+# Builds the bitcode (kernel.bc by default) unrolled by the given count,
+# where 1 keeps the loop as is.
+compile_kernel() {
+  bitcode=${2:-kernel.bc}
+  if command -v ${CLANG%% *} > /dev/null; then
+    $CLANG -emit-llvm -fno-unroll-loops -O3 -o $bitcode -c ../kernel.cpp
+  else
+    $LLVM_AS ../kernel.ll -o $bitcode
+  fi
+  if [ "$1" -gt 1 ]; then
+    $OPT --loop-unroll --unroll-count=$1 $bitcode -o $bitcode
+  fi
+}
+
+# Maps the bitcode (kernel.bc by default) with the param.json in the
+# current directory.
+run_mapper() {
+  $OPT -load $MAPPER_PASS -mapperPass ${1:-kernel.bc}
+}
+
+# Maps the dfg.json written by the pass with the param.json in the current
+# directory, using the standalone mapper.
+run_standalone_mapper() {
+  $MAPPER ${1:-dfg.json} param.json
+}
@@ -0,0 +1,3 @@
+. ../common.sh
+compile_kernel 1
+compile_kernel 2 kernel_unroll.bc
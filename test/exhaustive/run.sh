@@ -0,0 +1,8 @@
+. ../common.sh
+cat param_exhaustive.json > param.json
+run_mapper | tee trace_exhaustive.log
+cat param_parallel.json > param.json
+run_mapper | tee trace_parallel.log
+# The unrolled kernel needs thousands of backtracks at its lowest II.
+cat param_budget.json > param.json
+run_mapper kernel_unroll.bc | tee trace_budget.log
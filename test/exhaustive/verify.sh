@@ -0,0 +1,29 @@
+# The search reports its counters and maps the whole DFG, either alone
+# or with parallel tasks, at the same II.
+exhaustive_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_exhaustive.log)
+exhaustive_deepest=$(grep -aoP 'exhaustive search progress -- .*deepest: \K[0-9]+/[0-9]+' trace_exhaustive.log | tail -1)
+parallel_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_parallel.log)
+parallel_spawned=$(grep -ao 'exhaustive search spawns tasks' trace_parallel.log | wc -l)
+parallel_found=$(grep -ao 'exhaustive search finds a mapping' trace_parallel.log | wc -l)
+# The backtrack budget stops the search exactly at the limit and the
+# deepest partial mapping is restored node by node.
+budget_fail=$(grep -ao '\[fail\]' trace_budget.log | wc -l)
+budget_backtracks=$(grep -aoP 'exhaustive search progress -- .*backtracks: \K[0-9]+' trace_budget.log | tail -1)
+budget_deepest=$(grep -aoP 'runs out of budget; .* maps \K[0-9]+' trace_budget.log)
+budget_partial=$(grep -ao 'partial mapping -- dfgNode' trace_budget.log | wc -l)
+echo "exhaustive_II: $exhaustive_II"
+echo "exhaustive_deepest: $exhaustive_deepest"
+echo "parallel_II: $parallel_II"
+echo "parallel_spawned: $parallel_spawned"
+echo "parallel_found: $parallel_found"
+echo "budget_fail: $budget_fail"
+echo "budget_backtracks: $budget_backtracks"
+echo "budget_deepest: $budget_deepest"
+echo "budget_partial: $budget_partial"
+complete=$(echo "$exhaustive_deepest" | awk -F/ '{print ($1 == $2 && $1 > 0)}')
+if [ -n "$exhaustive_II" ] && [ "$complete" = 1 ] && [ "$parallel_II" = "$exhaustive_II" ] && [ "$parallel_spawned" -eq 1 ] && [ "$parallel_found" -ge 1 ] && [ "$budget_fail" -eq 1 ] && [ "$budget_backtracks" = 100 ] && [ -n "$budget_deepest" ] && [ "$budget_partial" -eq "$budget_deepest" ]; then
+    echo "Exhaustive Mapping Test Pass!"
+else
+    echo "Exhaustive Mapping Test Fail!"
+    exit 1
+fi
@@ -1,6 +1,6 @@
 #!/bin/bash
 
-count=$(grep -o 'sdiv' dfg.json | wc -l)
+count=$(grep '"org_opt"' dfg.json | grep -o 'sdiv' | wc -l)
 if [ "$count" -eq 4 ]
 then
     echo "Idiv Test Pass!"
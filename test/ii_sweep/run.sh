@@ -0,0 +1,7 @@
+. ../common.sh
+cat param_serial.json > param.json
+run_mapper | tee trace_serial.log
+cp config.json config_serial.json
+cat param_sweep.json > param.json
+run_mapper | tee trace_sweep.log
+cp config.json config_sweep.json
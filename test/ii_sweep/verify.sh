@@ -0,0 +1,19 @@
+# The sweep maps the IIs of a window concurrently and must accept the
+# lowest one that succeeds, i.e., the II (and the configuration) found by
+# the serial loop, even though lower IIs of the window failed.
+serial_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_serial.log)
+sweep_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_sweep.log)
+window_first_II=$(grep -aoP 'start parallel heuristic algorithm with II=\K[0-9]+' trace_sweep.log | tail -1)
+accepted_II=$(grep -aoP 'parallel heuristic algorithm succeeds with II=\K[0-9]+' trace_sweep.log)
+same_config=$(cmp -s config_serial.json config_sweep.json && echo 1 || echo 0)
+echo "serial_II: $serial_II"
+echo "sweep_II: $sweep_II"
+echo "window_first_II: $window_first_II"
+echo "accepted_II: $accepted_II"
+echo "same_config: $same_config"
+if [ -n "$serial_II" ] && [ "$sweep_II" = "$serial_II" ] && [ "$accepted_II" = "$serial_II" ] && [ "$window_first_II" -lt "$accepted_II" ] && [ "$same_config" -eq 1 ]; then
+    echo "II Sweep Test Pass!"
+else
+    echo "II Sweep Test Fail!"
+    exit 1
+fi
@@ -0,0 +1,25 @@
+; kernel() of kernel.cpp at -O3 -fno-unroll-loops, written out by hand for
+; hosts without clang-12 (see common.sh). The store to output[0] may alias
+; the loads, so the accumulation stays in memory within the loop.
+
+define dso_local void @_Z6kernelPfS_S_(float* nocapture readonly %input, float* nocapture %output, float* nocapture readonly %coefficient) local_unnamed_addr {
+entry:
+  br label %for.body
+
+for.cond.cleanup:
+  ret void
+
+for.body:
+  %indvars.iv = phi i64 [ 0, %entry ], [ %indvars.iv.next, %for.body ]
+  %arrayidx = getelementptr inbounds float, float* %input, i64 %indvars.iv
+  %0 = load float, float* %arrayidx, align 4
+  %arrayidx2 = getelementptr inbounds float, float* %coefficient, i64 %indvars.iv
+  %1 = load float, float* %arrayidx2, align 4
+  %mul = fmul float %0, %1
+  %2 = load float, float* %output, align 4
+  %add = fadd float %2, %mul
+  store float %add, float* %output, align 4
+  %indvars.iv.next = add nuw nsw i64 %indvars.iv, 1
+  %exitcond.not = icmp eq i64 %indvars.iv.next, 32
+  br i1 %exitcond.not, label %for.cond.cleanup, label %for.body
+}
@@ -0,0 +1,5 @@
+. ../common.sh
+for level in default debug trace; do
+  cat param_$level.json > param.json
+  run_mapper | tee trace_$level.log
+done
@@ -0,0 +1,32 @@
+# Without logLevel in param.json, only the results are logged, i.e., none
+# of the debug messages (e.g., the start of each II) nor the trace ones
+# (e.g., every placement). The level never changes the mapping.
+default_II=$(grep -ao '\[Mapping II: [0-9]*\]' trace_default.log | head -1 | grep -o '[0-9]*')
+debug_II=$(grep -ao '\[Mapping II: [0-9]*\]' trace_debug.log | head -1 | grep -o '[0-9]*')
+trace_II=$(grep -ao '\[Mapping II: [0-9]*\]' trace_trace.log | head -1 | grep -o '[0-9]*')
+default_success=$(grep -ao '\[Mapping Success\]' trace_default.log | wc -l)
+default_debug=$(grep -ao 'start heuristic algorithm with II' trace_default.log | wc -l)
+default_trace=$(grep -ao 'DEBUG' trace_default.log | wc -l)
+debug_debug=$(grep -ao 'start heuristic algorithm with II' trace_debug.log | wc -l)
+debug_trace=$(grep -ao 'schedule dfg node\[[0-9]*\] onto' trace_debug.log | wc -l)
+trace_trace=$(grep -ao 'schedule dfg node\[[0-9]*\] onto' trace_trace.log | wc -l)
+echo "II: $default_II (default), $debug_II (debug), $trace_II (trace)"
+echo "debug messages: $default_debug (default), $debug_debug (debug)"
+echo "trace messages: $default_trace (default), $debug_trace (debug), $trace_trace (trace)"
+if [ "$default_success" -ne 1 ] || [ -z "$default_II" ]; then
+    echo "Logging Test Fail! The results are not logged by default."
+    exit 1
+fi
+if [ "$default_debug" -ne 0 ] || [ "$default_trace" -ne 0 ]; then
+    echo "Logging Test Fail! The debug or trace messages are logged by default."
+    exit 1
+fi
+if [ "$debug_debug" -eq 0 ] || [ "$debug_trace" -ne 0 ] || [ "$trace_trace" -eq 0 ]; then
+    echo "Logging Test Fail! The debug and trace levels do not select their messages."
+    exit 1
+fi
+if [ "$debug_II" != "$default_II" ] || [ "$trace_II" != "$default_II" ]; then
+    echo "Logging Test Fail! The mapping differs across the levels."
+    exit 1
+fi
+echo "Logging Test Pass!"
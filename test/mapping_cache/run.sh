@@ -0,0 +1,14 @@
+. ../common.sh
+rm -rf cache
+run_mapper | tee trace_miss.log
+cp config.json config_miss.json
+run_mapper | tee trace_hit.log
+cp config.json config_hit.json
+# An invalid entry falls back to the mapping algorithm and is replaced.
+for entry in cache/*; do
+  echo "invalid" > $entry
+done
+run_mapper | tee trace_invalid.log
+cp config.json config_invalid.json
+run_mapper | tee trace_replaced.log
+cp config.json config_replaced.json
@@ -0,0 +1,30 @@
+# A hit skips the mapping algorithm and reproduces the configuration of the
+# miss; an invalid entry is mapped again and replaced by a valid one.
+for run in miss hit invalid replaced; do
+    eval ${run}_miss=$(grep -ao '\[Mapping cache miss: [0-9a-f]*\]' trace_$run.log | wc -l)
+    eval ${run}_hit=$(grep -ao '\[Mapping cache hit: [0-9a-f]*\]' trace_$run.log | wc -l)
+    eval ${run}_mapped=$(grep -ao 'start heuristic algorithm with II' trace_$run.log | wc -l)
+    eval ${run}_II=$(grep -ao '\[Mapping II: [0-9]*\]' trace_$run.log | head -1 | grep -o '[0-9]*')
+done
+echo "miss: $miss_miss, $invalid_miss (invalid)"
+echo "hit: $hit_hit, $replaced_hit (replaced)"
+echo "II: $miss_II, $hit_II (hit), $invalid_II (invalid), $replaced_II (replaced)"
+if [ -z "$miss_II" ] || [ "$miss_miss" -ne 1 ] || [ "$miss_mapped" -eq 0 ]; then
+    echo "Mapping Cache Test Fail! The first run is not mapped into the empty cache."
+    exit 1
+fi
+if [ "$hit_hit" -ne 1 ] || [ "$hit_mapped" -ne 0 ] || [ "$hit_II" != "$miss_II" ] ||
+   ! cmp -s config_miss.json config_hit.json; then
+    echo "Mapping Cache Test Fail! The hit does not reproduce the cached mapping."
+    exit 1
+fi
+if [ "$invalid_miss" -ne 1 ] || [ "$invalid_mapped" -eq 0 ] || [ "$invalid_II" != "$miss_II" ]; then
+    echo "Mapping Cache Test Fail! The invalid entry is not mapped again."
+    exit 1
+fi
+if [ "$replaced_hit" -ne 1 ] || [ "$replaced_mapped" -ne 0 ] ||
+   ! cmp -s config_invalid.json config_replaced.json; then
+    echo "Mapping Cache Test Fail! The invalid entry is not replaced."
+    exit 1
+fi
+echo "Mapping Cache Test Pass!"
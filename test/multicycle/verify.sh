@@ -1,6 +1,6 @@
-exclusive_dfg_count=$(grep -o 'id' exclusive_dfg.json | wc -l)
-distributed_dfg_count=$(grep -o 'id' distributed_dfg.json | wc -l)
-inclusive_dfg_count=$(grep -o 'id' inclusive_dfg.json | wc -l)
+exclusive_dfg_count=$(grep -o '"id"' exclusive_dfg.json | wc -l)
+distributed_dfg_count=$(grep -o '"id"' distributed_dfg.json | wc -l)
+inclusive_dfg_count=$(grep -o '"id"' inclusive_dfg.json | wc -l)
 
 exclusive_mapping_ii=$(grep -aoP '\[Mapping II: \K[^]]+' trace_exclusive.log)
 distributed_mapping_ii=$(grep -aoP '\[Mapping II: \K[^]]+' trace_distributed.log)
@@ -0,0 +1,5 @@
+. ../common.sh
+cat param_greedy.json > param.json
+run_mapper | tee trace_greedy.log
+cat param_negotiated.json > param.json
+run_mapper | tee trace_negotiated.log
@@ -0,0 +1,17 @@
+# The greedy mapping of the 4x unrolled kernel on the 3x3 CGRA, whose
+# tiles bypass at most one datum per cycle, gives up II=8 on a failed
+# placement, while the negotiated routing maps the DFG node with II=8.
+greedy_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_greedy.log)
+negotiated_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_negotiated.log)
+negotiated_iterations=$(grep -ao 'negotiated routing iteration [0-9]* of dfg node\[[0-9]*\] onto' trace_negotiated.log | wc -l)
+negotiated_success_II=$(grep -aoP 'negotiated routing iteration [0-9]+ of dfg node\[[0-9]+\] succeeds within II: \K[0-9]+' trace_negotiated.log | tail -1)
+echo "greedy_II: $greedy_II"
+echo "negotiated_II: $negotiated_II"
+echo "negotiated_iterations: $negotiated_iterations"
+echo "negotiated_success_II: $negotiated_success_II"
+if [ -n "$greedy_II" ] && [ -n "$negotiated_II" ] && [ "$negotiated_II" -lt "$greedy_II" ] && [ "$negotiated_iterations" -gt 0 ] && [ "$negotiated_success_II" = "$negotiated_II" ]; then
+    echo "Negotiated Routing Test Pass!"
+else
+    echo "Negotiated Routing Test Fail!"
+    exit 1
+fi
@@ -1,7 +1,7 @@
-icmpbr=$(grep -o 'icmpbr' dfg.json | wc -l)
-phiadd=$(grep -o 'phiadd' dfg.json | wc -l)
-fp2fx=$(grep -o 'fp2fx' dfg.json | wc -l)
-faddmuladd=$(grep -o 'faddmuladd' dfg.json | wc -l)
+icmpbr=$(grep '"org_opt"' dfg.json | grep -o 'icmpbr' | wc -l)
+phiadd=$(grep '"org_opt"' dfg.json | grep -o 'phiadd' | wc -l)
+fp2fx=$(grep '"org_opt"' dfg.json | grep -o 'fp2fx' | wc -l)
+faddmuladd=$(grep '"org_opt"' dfg.json | grep -o 'faddmuladd' | wc -l)
 if [ "$icmpbr" -eq 1 ] && [ "$phiadd" -eq 1 ] && [ "$fp2fx" -eq 1 ] && [ "$faddmuladd" -eq 1 ]; then
     echo "Nonlinear Test Pass!"
 else
@@ -0,0 +1,18 @@
+# The refinement of the 4x unrolled kernel (with the fixed seed of its
+# moves) keeps the II of the greedy mapping and lowers its cost, i.e.,
+# the occupied link slots and registers and the active DVFS islands.
+greedy_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_greedy.log)
+refine_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_refine.log)
+refine_success=$(grep -ao '\[Mapping Success\]' trace_refine.log | wc -l)
+initial_cost=$(grep -aoP 'refinement ends after .*; cost: \K[0-9]+' trace_refine.log)
+refined_cost=$(grep -aoP 'refinement ends after .*; cost: [0-9]+ -> \K[0-9]+' trace_refine.log)
+echo "greedy_II: $greedy_II"
+echo "refine_II: $refine_II"
+echo "initial_cost: $initial_cost"
+echo "refined_cost: $refined_cost"
+if [ -n "$greedy_II" ] && [ "$refine_II" = "$greedy_II" ] && [ "$refine_success" -eq 1 ] && [ -n "$refined_cost" ] && [ "$refined_cost" -lt "$initial_cost" ]; then
+    echo "Refinement Test Pass!"
+else
+    echo "Refinement Test Fail!"
+    exit 1
+fi
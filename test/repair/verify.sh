@@ -0,0 +1,16 @@
+# The greedy mapping gives up II=9 of the 4x unrolled kernel, while the
+# repair rips up the neighborhood of the failed DFG node and maps it.
+greedy_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_greedy.log)
+repair_II=$(grep -aoP '\[Mapping II: \K[0-9]+' trace_repair.log)
+repair_attempts=$(grep -ao 'repair attempt [0-9]* of dfg node\[[0-9]*\] rips up' trace_repair.log | wc -l)
+repaired_II=$(grep -aoP 'repair attempt [0-9]+ of dfg node\[[0-9]+\] succeeds within II: \K[0-9]+' trace_repair.log | tail -1)
+echo "greedy_II: $greedy_II"
+echo "repair_II: $repair_II"
+echo "repair_attempts: $repair_attempts"
+echo "repaired_II: $repaired_II"
+if [ -n "$greedy_II" ] && [ -n "$repair_II" ] && [ "$repair_II" -lt "$greedy_II" ] && [ "$repair_attempts" -gt 0 ] && [ "$repaired_II" = "$repair_II" ]; then
+    echo "Repair Test Pass!"
+else
+    echo "Repair Test Fail!"
+    exit 1
+fi
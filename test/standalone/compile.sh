@@ -0,0 +1,2 @@
+. ../common.sh
+compile_kernel 2
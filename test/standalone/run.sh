@@ -0,0 +1,9 @@
+. ../common.sh
+for mode in fused distributed; do
+  cat param_$mode.json > param.json
+  run_mapper | tee trace_${mode}_pass.log
+  cp dfg.json dfg_$mode.json
+  cp config.json config_${mode}_pass.json
+  run_standalone_mapper dfg_$mode.json | tee trace_${mode}_standalone.log
+  cp config.json config_${mode}_standalone.json
+done
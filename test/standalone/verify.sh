@@ -0,0 +1,29 @@
+# The standalone mapper reads the mapped DFG back from dfg.json and should
+# generate the same config.json as the pass, for a DFG with fused nodes and
+# for one whose multi-cycle nodes are split by the distributed strategy.
+for mode in fused distributed; do
+    pass_II=$(grep -ao '\[Mapping II: [0-9]*\]' trace_${mode}_pass.log | head -1 | grep -o '[0-9]*')
+    standalone_II=$(grep -ao '\[Mapping II: [0-9]*\]' trace_${mode}_standalone.log | head -1 | grep -o '[0-9]*')
+    fused_count=$(grep -c '"fused"       : true' dfg_$mode.json)
+    echo "$mode pass_II: $pass_II"
+    echo "$mode standalone_II: $standalone_II"
+    if [ "$fused_count" -eq 0 ]; then
+        echo "Standalone Mapper Test Fail! The $mode DFG has no fused node."
+        exit 1
+    fi
+    if [ -z "$pass_II" ] || [ -z "$standalone_II" ] || [ "$standalone_II" -ne "$pass_II" ]; then
+        echo "Standalone Mapper Test Fail! The $mode DFG is mapped at a different II."
+        exit 1
+    fi
+    if ! cmp -s config_${mode}_pass.json config_${mode}_standalone.json; then
+        echo "Standalone Mapper Test Fail! The $mode config.json differs from the pass."
+        exit 1
+    fi
+done
+# The split nodes share the ID of the node they are split from.
+split_count=$(grep '"id"' dfg_distributed.json | sort | uniq -d | wc -l)
+if [ "$split_count" -eq 0 ]; then
+    echo "Standalone Mapper Test Fail! The distributed DFG has no split node."
+    exit 1
+fi
+echo "Standalone Mapper Test Pass!"
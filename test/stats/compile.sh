@@ -0,0 +1,2 @@
+clang-12 -emit-llvm -fno-unroll-loops -O3 -o kernel.bc -c kernel.cpp
+opt-12 --loop-unroll --unroll-count=4 kernel.bc -o kernel_unroll.bc
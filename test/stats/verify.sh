@@ -0,0 +1,14 @@
+II=$(grep -ao '\[Mapping II: [0-9]*\]' trace.log | head -1 | grep -o '[0-9]*')
+stats_II=$(grep -o '"II": [0-9-]*' mapper_stats.json | grep -o '[0-9-]*$')
+schedule_calls=$(grep -A1 '"Mapper::schedule"' mapper_stats.json | grep -o '"calls": [0-9]*' | grep -o '[0-9]*$')
+expansions=$(grep -o '"router expansions": [0-9]*' mapper_stats.json | grep -o '[0-9]*$')
+echo "II: $II"
+echo "stats_II: $stats_II"
+echo "schedule_calls: $schedule_calls"
+echo "expansions: $expansions"
+if [ -n "$II" ] && [ "$stats_II" = "$II" ] && [ -n "$schedule_calls" ] && [ "$schedule_calls" -gt 0 ] && [ -n "$expansions" ] && [ "$expansions" -gt 0 ]; then
+    echo "Mapper Stats Test Pass!"
+else
+    echo "Mapper Stats Test Fail!"
+    exit 1
+fi
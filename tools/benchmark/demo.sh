@@ -0,0 +1,20 @@
+#!/usr/bin/env bash
+# Builds the mapper at the given revision (default: the previous commit)
+# and compares its mapping time against the current build on test/kernels,
+# then shows how the current build scales with the number of threads and
+# sweeps it over the fabric sizes, unroll factors and mapping modes.
+REF=${1:-HEAD~1}
+REF_DIR=$(mktemp -d)
+
+git worktree add --detach $REF_DIR $REF
+cmake -S $REF_DIR -B $REF_DIR/build
+cmake --build $REF_DIR/build -j
+
+python3 router_bench.py --baseline $REF_DIR/build/src/libmapperPass.so \
+                        --candidate ../../build/src/libmapperPass.so
+
+git worktree remove --force $REF_DIR
+
+python3 scaling_bench.py --lib ../../build/src/libmapperPass.so
+
+python3 suite_bench.py --lib ../../build/src/libmapperPass.so
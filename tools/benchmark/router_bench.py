@@ -0,0 +1,120 @@
+# ----------------------------------------------------------------------------
+#   Filename: router_bench.py                                               /
+#   Description: compare the mapping time of two mapper builds on the       /
+#                kernels under test/kernels                                 /
+# ----------------------------------------------------------------------------
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import tempfile
+
+# ----------------------------------------------------------------------------
+#   global variables                                                        /
+# ----------------------------------------------------------------------------
+REPO_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+KERNELS_DIR = os.path.join(REPO_DIR, "test", "kernels")
+ELAPSED_PATTERN = re.compile(r"Mapping algorithm elapsed time=(\d+)ms")
+II_PATTERN = re.compile(r"\[Mapping II: (\d+)\]")
+
+
+# ----------------------------------------------------------------------------
+#   helper functions                                                        /
+# ----------------------------------------------------------------------------
+def collectKernels(names):
+    kernels = []
+    for name in sorted(os.listdir(KERNELS_DIR)):
+        path = os.path.join(KERNELS_DIR, name)
+        if names and name not in names:
+            continue
+        # Only the kernels shipped with a mapping configuration are measured.
+        if os.path.isfile(os.path.join(path, "param.json")) and \
+           os.path.isfile(os.path.join(path, "compile.sh")):
+            kernels.append(name)
+    return kernels
+
+
+def compileKernel(name, workDir):
+    kernelDir = os.path.join(workDir, name)
+    shutil.copytree(os.path.join(KERNELS_DIR, name), kernelDir)
+    subprocess.run(["bash", "compile.sh"], cwd=kernelDir,
+                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    if not os.path.isfile(os.path.join(kernelDir, "kernel.bc")):
+        return None
+    return kernelDir
+
+
+def runMapper(opt, lib, kernelDir, timeout, env=None):
+    try:
+        result = subprocess.run([opt, "-load", lib, "-mapperPass", "kernel.bc",
+                                 "-o", os.devnull], cwd=kernelDir,
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                timeout=timeout, env=env)
+    except subprocess.TimeoutExpired:
+        return None, None
+    log = result.stdout.decode("utf-8", "replace")
+    elapsed = ELAPSED_PATTERN.search(log)
+    ii = II_PATTERN.search(log)
+    return (int(elapsed.group(1)) if elapsed else None,
+            int(ii.group(1)) if ii else None)
+
+
+def bestOf(opt, lib, kernelDir, repeat, timeout, env=None):
+    best, ii = None, None
+    for _ in range(repeat):
+        elapsed, ii = runMapper(opt, lib, kernelDir, timeout, env)
+        if elapsed is None:
+            return None, ii
+        best = elapsed if best is None else min(best, elapsed)
+    return best, ii
+
+
+# ----------------------------------------------------------------------------
+#   main                                                                    /
+# ----------------------------------------------------------------------------
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--baseline", required=True,
+                        help="libmapperPass.so built from the reference revision")
+    parser.add_argument("--candidate",
+                        default=os.path.join(REPO_DIR, "build", "src", "libmapperPass.so"),
+                        help="libmapperPass.so under evaluation")
+    parser.add_argument("--opt", default="opt-12")
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--timeout", type=int, default=600)
+    parser.add_argument("kernels", nargs="*",
+                        help="kernel directories under test/kernels (default: all)")
+    args = parser.parse_args()
+
+    baseline = os.path.abspath(args.baseline)
+    candidate = os.path.abspath(args.candidate)
+    workDir = tempfile.mkdtemp(prefix="router_bench_")
+
+    print("%-16s %8s %8s %12s %12s %8s" %
+          ("kernel", "II(ref)", "II(new)", "ref(ms)", "new(ms)", "speedup"))
+    totalRef, totalNew = 0, 0
+    for name in collectKernels(args.kernels):
+        kernelDir = compileKernel(name, workDir)
+        if kernelDir is None:
+            print("%-16s failed to compile" % name)
+            continue
+        refTime, refII = bestOf(args.opt, baseline, kernelDir, args.repeat, args.timeout)
+        newTime, newII = bestOf(args.opt, candidate, kernelDir, args.repeat, args.timeout)
+        if refTime is None or newTime is None:
+            print("%-16s %8s %8s %12s %12s %8s" %
+                  (name, refII, newII, refTime, newTime, "-"))
+            continue
+        totalRef += refTime
+        totalNew += newTime
+        print("%-16s %8s %8s %12d %12d %7.2fx" %
+              (name, refII, newII, refTime, newTime, refTime / max(newTime, 1)))
+    if totalNew > 0:
+        print("%-16s %8s %8s %12d %12d %7.2fx" %
+              ("total", "", "", totalRef, totalNew, totalRef / totalNew))
+    shutil.rmtree(workDir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
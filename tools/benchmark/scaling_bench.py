@@ -0,0 +1,69 @@
+# ----------------------------------------------------------------------------
+#   Filename: scaling_bench.py                                              /
+#   Description: measure how the mapping time of one mapper build scales    /
+#                with the number of OpenMP threads on test/kernels          /
+# ----------------------------------------------------------------------------
+
+import argparse
+import os
+import shutil
+import tempfile
+
+from router_bench import REPO_DIR, collectKernels, compileKernel, bestOf
+
+
+# ----------------------------------------------------------------------------
+#   main                                                                    /
+# ----------------------------------------------------------------------------
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--lib",
+                        default=os.path.join(REPO_DIR, "build", "src", "libmapperPass.so"),
+                        help="libmapperPass.so under evaluation")
+    parser.add_argument("--opt", default="opt-12")
+    parser.add_argument("--threads", type=int, nargs="+", default=[1, 2, 4, 8, 16])
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--timeout", type=int, default=600)
+    parser.add_argument("kernels", nargs="*",
+                        help="kernel directories under test/kernels (default: all)")
+    args = parser.parse_args()
+
+    lib = os.path.abspath(args.lib)
+    workDir = tempfile.mkdtemp(prefix="scaling_bench_")
+
+    # The speedup is reported against the first thread count, and the II
+    # is expected to be the same whatever the number of threads is.
+    print("%-16s %4s" % ("kernel", "II") +
+          "".join(" %10s" % ("%dT(ms)" % t) for t in args.threads) +
+          " %8s" % "speedup")
+    totals = [0] * len(args.threads)
+    for name in collectKernels(args.kernels):
+        kernelDir = compileKernel(name, workDir)
+        if kernelDir is None:
+            print("%-16s failed to compile" % name)
+            continue
+        times, iis = [], set()
+        for threads in args.threads:
+            env = dict(os.environ, OMP_NUM_THREADS=str(threads))
+            elapsed, ii = bestOf(args.opt, lib, kernelDir, args.repeat,
+                                 args.timeout, env)
+            times.append(elapsed)
+            iis.add(ii)
+        ii = iis.pop() if len(iis) == 1 else "diff"
+        if None in times:
+            print("%-16s %4s" % (name, ii) +
+                  "".join(" %10s" % t for t in times) + " %8s" % "-")
+            continue
+        totals = [total + t for total, t in zip(totals, times)]
+        print("%-16s %4s" % (name, ii) +
+              "".join(" %10d" % t for t in times) +
+              " %7.2fx" % (times[0] / max(times[-1], 1)))
+    if totals[-1] > 0:
+        print("%-16s %4s" % ("total", "") +
+              "".join(" %10d" % t for t in totals) +
+              " %7.2fx" % (totals[0] / totals[-1]))
+    shutil.rmtree(workDir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
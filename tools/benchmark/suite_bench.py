@@ -0,0 +1,237 @@
+# ----------------------------------------------------------------------------
+#   Filename: suite_bench.py                                                /
+#   Description: sweep one mapper build over the kernels under test/kernels  /
+#                with different fabric sizes, unroll factors and mapping    /
+#                modes, and check the results against a stored baseline     /
+# ----------------------------------------------------------------------------
+
+import argparse
+import json
+import os
+import re
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+
+from router_bench import REPO_DIR, KERNELS_DIR, collectKernels, II_PATTERN
+
+# ----------------------------------------------------------------------------
+#   global variables                                                        /
+# ----------------------------------------------------------------------------
+RESMII_PATTERN = re.compile(r"\[ResMII: (\d+)\]")
+RECMII_PATTERN = re.compile(r"\[RecMII: (\d+)\]")
+XBAR_PATTERN = re.compile(r"avg xbar utilization: ([0-9.e+-]+)%")
+MODES = ["heuristic", "incremental", "exhaustive"]
+
+
+# ----------------------------------------------------------------------------
+#   helper functions                                                        /
+# ----------------------------------------------------------------------------
+def prepareKernel(name, workDir, bcDir, opt, unrolls):
+    """Copies the kernel and provides kernel_u<N>.bc for each unroll factor.
+    The bitcode is taken from <bcDir>/<name>.bc or the kernel directory, and
+    compile.sh is only run when neither exists, so that the suite runs
+    offline without clang."""
+    kernelDir = os.path.join(workDir, name)
+    shutil.copytree(os.path.join(KERNELS_DIR, name), kernelDir)
+    kernelBC = os.path.join(kernelDir, "kernel.bc")
+    if bcDir and os.path.isfile(os.path.join(bcDir, name + ".bc")):
+        shutil.copy(os.path.join(bcDir, name + ".bc"), kernelBC)
+    elif not os.path.isfile(kernelBC):
+        subprocess.run(["bash", "compile.sh"], cwd=kernelDir,
+                       stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    if not os.path.isfile(kernelBC):
+        return None
+    for unroll in unrolls:
+        unrolledBC = os.path.join(kernelDir, "kernel_u%d.bc" % unroll)
+        if unroll == 1:
+            shutil.copy(kernelBC, unrolledBC)
+        else:
+            subprocess.run([opt, "--loop-unroll", "--unroll-count=%d" % unroll,
+                            kernelBC, "-o", unrolledBC],
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return kernelDir
+
+
+def writeParam(kernelDir, runDir, fabric, mode, exhaustiveTimeLimit):
+    with open(os.path.join(kernelDir, "param.json")) as f:
+        param = json.load(f)
+    param["row"] = fabric
+    param["column"] = fabric
+    param["heuristicMapping"] = mode != "exhaustive"
+    param["incrementalMapping"] = mode == "incremental"
+    param["exhaustiveTimeLimit"] = exhaustiveTimeLimit
+    param["logLevel"] = "info"
+    param.pop("mappingCacheDir", None)
+    with open(os.path.join(runDir, "param.json"), "w") as f:
+        json.dump(param, f, indent=2)
+
+
+def runWithRusage(cmd, cwd, logPath, timeout):
+    """Runs the command with its output into the log, and returns whether it
+    finishes in time along with its peak RSS in KB."""
+    with open(logPath, "w") as log:
+        process = subprocess.Popen(cmd, cwd=cwd, stdout=log,
+                                   stderr=subprocess.STDOUT)
+    deadline = time.time() + timeout
+    while True:
+        pid, status, rusage = os.wait4(process.pid, os.WNOHANG)
+        if pid != 0:
+            return True, rusage.ru_maxrss
+        if time.time() > deadline:
+            process.send_signal(signal.SIGKILL)
+            pid, status, rusage = os.wait4(process.pid, 0)
+            return False, rusage.ru_maxrss
+        time.sleep(0.01)
+
+
+def runMapper(opt, optFlags, lib, runDir, bc, timeout):
+    finished, rss = runWithRusage([opt] + optFlags +
+                                  ["-load", lib, "-mapperPass", bc,
+                                   "-o", os.devnull],
+                                  runDir, os.path.join(runDir, "trace.log"),
+                                  timeout)
+    with open(os.path.join(runDir, "trace.log"), errors="replace") as f:
+        log = f.read()
+    record = {"finished": finished, "rss_kb": rss}
+    for key, pattern in [("II", II_PATTERN), ("ResMII", RESMII_PATTERN),
+                         ("RecMII", RECMII_PATTERN)]:
+        match = pattern.search(log)
+        record[key] = int(match.group(1)) if match else None
+    xbar = XBAR_PATTERN.search(log)
+    record["xbar_utilization"] = float(xbar.group(1)) if xbar else None
+    statsPath = os.path.join(runDir, "mapper_stats.json")
+    if finished and os.path.isfile(statsPath):
+        with open(statsPath) as f:
+            phases = json.load(f)["phases"]
+        record["dfg_ms"] = phases["DFG::construct"]["ms"] + \
+                           phases["DFG::fusion"]["ms"]
+        record["map_ms"] = phases["mapDFG"]["ms"]
+    else:
+        record["dfg_ms"] = None
+        record["map_ms"] = None
+    return record
+
+
+def findRegressions(results, baseline, args):
+    regressions = []
+    for key, new in sorted(results.items()):
+        ref = baseline.get(key)
+        if ref is None:
+            continue
+        if ref["II"] is not None and (new["II"] is None or new["II"] > ref["II"]):
+            regressions.append("%s: II %s -> %s" % (key, ref["II"], new["II"]))
+        for metric, tolerance, slack in [
+                ("map_ms", args.time_tolerance, args.time_slack),
+                ("dfg_ms", args.time_tolerance, args.time_slack),
+                ("rss_kb", args.rss_tolerance, 0)]:
+            if ref.get(metric) is None or new.get(metric) is None:
+                continue
+            if new[metric] > ref[metric] * (1 + tolerance) + slack:
+                regressions.append("%s: %s %.1f -> %.1f" %
+                                   (key, metric, ref[metric], new[metric]))
+    return regressions
+
+
+def show(value, format):
+    return "-" if value is None else format % value
+
+
+# ----------------------------------------------------------------------------
+#   main                                                                    /
+# ----------------------------------------------------------------------------
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--lib",
+                        default=os.path.join(REPO_DIR, "build", "src", "libmapperPass.so"),
+                        help="libmapperPass.so under evaluation")
+    parser.add_argument("--opt", default="opt-12")
+    parser.add_argument("--legacy-pm", action="store_true",
+                        help="pass -enable-new-pm=0 to opt (LLVM 13 and later)")
+    parser.add_argument("--bc-dir",
+                        help="directory of the prebuilt <kernel>.bc files")
+    parser.add_argument("--fabrics", type=int, nargs="+", default=[4, 6, 8, 12])
+    parser.add_argument("--unrolls", type=int, nargs="+", default=[1, 2, 4])
+    parser.add_argument("--modes", nargs="+", choices=MODES, default=MODES)
+    parser.add_argument("--exhaustive-time-limit", type=int, default=60000,
+                        help="exhaustiveTimeLimit in ms of the exhaustive mode")
+    parser.add_argument("--timeout", type=int, default=600)
+    parser.add_argument("--results", default="bench_results.json",
+                        help="where the results of this sweep are written")
+    parser.add_argument("--baseline",
+                        help="results of an earlier sweep to compare against")
+    parser.add_argument("--time-tolerance", type=float, default=0.25,
+                        help="allowed relative slowdown of the DFG build and mapping")
+    parser.add_argument("--time-slack", type=float, default=10,
+                        help="allowed absolute slowdown in ms on top of the tolerance")
+    parser.add_argument("--rss-tolerance", type=float, default=0.25,
+                        help="allowed relative growth of the peak RSS")
+    parser.add_argument("kernels", nargs="*",
+                        help="kernel directories under test/kernels (default: all)")
+    args = parser.parse_args()
+
+    lib = os.path.abspath(args.lib)
+    optFlags = ["-enable-new-pm=0"] if args.legacy_pm else []
+    bcDir = os.path.abspath(args.bc_dir) if args.bc_dir else None
+    workDir = tempfile.mkdtemp(prefix="suite_bench_")
+
+    # The incremental mode starts from the mapping of the heuristic one on
+    # the same fabric, so the heuristic one always goes first.
+    modes = [mode for mode in MODES if mode in args.modes]
+    print("%-28s %4s %4s %10s %10s %10s %8s" %
+          ("kernel/unroll/fabric/mode", "II", "MII", "dfg(ms)", "map(ms)",
+           "rss(MB)", "xbar(%)"))
+    results = {}
+    for name in collectKernels(args.kernels):
+        kernelDir = prepareKernel(name, workDir, bcDir, args.opt, args.unrolls)
+        if kernelDir is None:
+            print("%-28s failed to compile" % name)
+            continue
+        for unroll in args.unrolls:
+            bc = os.path.join(kernelDir, "kernel_u%d.bc" % unroll)
+            if not os.path.isfile(bc):
+                print("%-28s failed to unroll" % ("%s/u%d" % (name, unroll)))
+                continue
+            for fabric in args.fabrics:
+                runDir = os.path.join(kernelDir, "u%d_%dx%d" % (unroll, fabric, fabric))
+                os.makedirs(runDir)
+                for mode in modes:
+                    if mode == "incremental" and \
+                       not os.path.isfile(os.path.join(runDir, "increMapInput.json")):
+                        continue
+                    key = "%s/u%d/%dx%d/%s" % (name, unroll, fabric, fabric, mode)
+                    writeParam(kernelDir, runDir, fabric, mode,
+                               args.exhaustive_time_limit)
+                    record = runMapper(args.opt, optFlags, lib, runDir, bc,
+                                       args.timeout)
+                    results[key] = record
+                    mii = None
+                    if record["ResMII"] is not None and record["RecMII"] is not None:
+                        mii = max(record["ResMII"], record["RecMII"])
+                    print("%-28s %4s %4s %10s %10s %10s %8s" %
+                          (key, show(record["II"], "%d"), show(mii, "%d"),
+                           show(record["dfg_ms"], "%.1f"),
+                           show(record["map_ms"], "%.1f"),
+                           show(record["rss_kb"] / 1024.0, "%.1f"),
+                           show(record["xbar_utilization"], "%.1f")))
+                    sys.stdout.flush()
+    shutil.rmtree(workDir, ignore_errors=True)
+
+    with open(args.results, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    if args.baseline is None:
+        return 0
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    regressions = findRegressions(results, baseline, args)
+    for regression in regressions:
+        print("[regression] " + regression)
+    print("%d regressions against %s" % (len(regressions), args.baseline))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())